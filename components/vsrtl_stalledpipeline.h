@@ -0,0 +1,58 @@
+#pragma once
+
+#include "vsrtl_adder.h"
+#include "vsrtl_constant.h"
+#include "vsrtl_decollator.h"
+#include "vsrtl_design.h"
+#include "vsrtl_logicgate.h"
+#include "vsrtl_register.h"
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * A pipeline of S stages of L lanes, where each stage adds the lane index to the values of the previous stage. The
+ * pipeline is stalled in 7 out of 8 cycles: its enabled registers only advance when the three lower bits of a free
+ * running counter are set.
+ */
+template <unsigned int S, unsigned int L>
+class ScalableStalledPipeline : public Design {
+public:
+    static constexpr unsigned int stages = S;
+    static constexpr unsigned int lanes = L;
+
+    ScalableStalledPipeline() : Design("Stalled pipeline") {
+        // Counter and stall logic
+        counter->out >> inc->op1;
+        1 >> inc->op2;
+        inc->out >> counter->in;
+        counter->out >> counterBits->in;
+        for (unsigned int i = 0; i < 3; i++)
+            *counterBits->out[i] >> *advance->in[i];
+
+        for (unsigned int s = 0; s < S; s++) {
+            for (unsigned int l = 0; l < L; l++) {
+                const unsigned int idx = s * L + l;
+                if (s == 0)
+                    counter->out >> adders[idx]->op1;
+                else
+                    regs[idx - L]->out >> adders[idx]->op1;
+                l >> adders[idx]->op2;
+                adders[idx]->out >> regs[idx]->in;
+                advance->out >> regs[idx]->enable;
+                0 >> regs[idx]->clear;
+            }
+        }
+    }
+
+    SUBCOMPONENT(counter, Register<32>);
+    SUBCOMPONENT(inc, Adder<32>);
+    SUBCOMPONENT(counterBits, Decollator<32>);
+    SUBCOMPONENT(advance, TYPE(And<1, 3>));
+    SUBCOMPONENTS(adders, Adder<32>, S* L);
+    SUBCOMPONENTS(regs, RegisterClEn<32>, S* L);
+};
+
+using StalledPipeline = ScalableStalledPipeline<10, 10>;
+}  // namespace core
+}  // namespace vsrtl
@@ -11,12 +11,17 @@
 namespace vsrtl {
 namespace core {
 
-class XorNetwork : public Design {
+/**
+ * A network of rows x C 1-bit gates, driven by a register. The number of columns may be scaled to create arbitrarily
+ * large designs.
+ */
+template <unsigned int C>
+class ScalableXorNetwork : public Design {
 public:
     static constexpr unsigned int rows = 100;
-    static constexpr unsigned int cols = 50;
+    static constexpr unsigned int cols = C;
 
-    XorNetwork() : Design("XOr Network") {
+    ScalableXorNetwork() : Design("XOr Network") {
         // Driver setup
         0x1234abcd >> adder->op1;
         seedReg->out >> adder->op2;
@@ -53,5 +58,7 @@ public:
     SUBCOMPONENT(decol, Decollator<rows>);
     SUBCOMPONENT(adder, Adder<rows>);
 };
+
+using XorNetwork = ScalableXorNetwork<50>;
 }  // namespace core
 }  // namespace vsrtl
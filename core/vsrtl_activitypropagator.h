@@ -0,0 +1,109 @@
+#ifndef VSRTL_ACTIVITYPROPAGATOR_H
+#define VSRTL_ACTIVITYPROPAGATOR_H
+
+#include "../interface/vsrtl_defines.h"
+#include "vsrtl_port.h"
+#include "vsrtl_portgraph.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The ActivityPropagator class
+ * Event-driven propagation of a design. Instead of reevaluating the entire propagation stack, only the ports within
+ * the fan-out cones of ports which changed value are reevaluated.
+ * Each cycle is seeded by the source ports of the design (outputs of synchronous and stateful components). Whenever a
+ * reevaluated port changes value, its readers are marked for reevaluation. Ports are visited in propagation-stack
+ * order, which guarantees that all dependencies of a port have settled before the port is reevaluated; the result is
+ * thus identical to a full propagation of the design.
+ *
+ * It is required that ports of the propagation stack occupy the first slots of the value table, in propagation order,
+ * such that the slot of a scheduled port equals its index in the propagation stack.
+ */
+class ActivityPropagator {
+public:
+    /**
+     * @brief initialize
+     * @param seeds: indices (within @p propagationStack) of the ports which must be reevaluated every cycle.
+     */
+    void initialize(const std::vector<PortBase*>& propagationStack, const PortGraph& graph,
+                    const std::vector<uint32_t>& seeds) {
+        m_propagationStack = &propagationStack;
+        m_graph = &graph;
+        const size_t words = (propagationStack.size() + 63) / 64;
+        m_dirty.assign(words, 0);
+        m_seeds.assign(words, 0);
+        for (const auto& s : seeds)
+            m_seeds[s / 64] |= VSRTL_VT_U(1) << (s % 64);
+    }
+
+    /**
+     * @brief markDirty
+     * Marks the port at @p idx (within the propagation stack) for reevaluation in the next propagation. Used for
+     * source ports which are not seeds, but are known to have changed. Indices beyond the propagation stack are
+     * ignored.
+     */
+    void markDirty(uint32_t idx) {
+        if (idx < m_propagationStack->size())
+            m_dirty[idx / 64] |= VSRTL_VT_U(1) << (idx % 64);
+    }
+
+    /**
+     * @brief propagate
+     * Reevaluates the ports of the design which may have changed since the last propagation.
+     */
+    void propagate() {
+        const auto& stack = *m_propagationStack;
+        const size_t n = stack.size();
+        for (size_t w = 0; w < m_dirty.size(); w++)
+            m_dirty[w] |= m_seeds[w];
+
+        for (size_t w = 0; w < m_dirty.size(); w++) {
+            // Readers are always located after their dependencies in the propagation stack, but may reside within the
+            // word currently being processed; the word is therefore reloaded after each evaluation.
+            while (m_dirty[w] != 0) {
+                const unsigned bit = ctz(m_dirty[w]);
+                m_dirty[w] &= m_dirty[w] - 1;
+                const uint32_t idx = static_cast<uint32_t>(w * 64 + bit);
+
+                PortBase* port = stack[idx];
+                const VSRTL_VT_U preValue = *port->valueSlot();
+                port->setPortValue();
+                if (*port->valueSlot() == preValue)
+                    continue;
+
+                for (const auto& reader : m_graph->readers(idx)) {
+                    if (reader < n)
+                        m_dirty[reader / 64] |= VSRTL_VT_U(1) << (reader % 64);
+                }
+            }
+        }
+    }
+
+private:
+    static unsigned ctz(VSRTL_VT_U v) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctzll(v));
+#else
+        unsigned n = 0;
+        while ((v & 0b1) == 0) {
+            v >>= 1;
+            n++;
+        }
+        return n;
+#endif
+    }
+
+    const std::vector<PortBase*>* m_propagationStack = nullptr;
+    const PortGraph* m_graph = nullptr;
+    std::vector<VSRTL_VT_U> m_dirty;
+    std::vector<VSRTL_VT_U> m_seeds;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_ACTIVITYPROPAGATOR_H
@@ -16,6 +16,15 @@ public:
         out << [=] { return op1.sValue() + op2.sValue(); };
     }
 
+    std::string nativeExpression(const PortBase*, const NativeOperand& operand) const override {
+        // Two's complement addition; sign extension of the operands does not affect the masked result.
+        return "(" + operand(&op1) + " + " + operand(&op2) + ")";
+    }
+
+    BatchPrimitive batchPrimitive(const PortBase*) const override {
+        return {BatchPrimitive::Op::add, {&op1, &op2}, 0};
+    }
+
     INPUTPORT(op1, W);
     INPUTPORT(op2, W);
     OUTPUTPORT(out, W);
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <assert.h>
+#include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "../interface/vsrtl_defines.h"
@@ -24,6 +27,8 @@ public:
     virtual ~AddressSpace() {}
 
     virtual void writeMem(VSRTL_VT_U address, VSRTL_VT_U value, int bytes) {
+        for (const auto& observer : m_writeObservers)
+            observer.second(address, bytes);
         // writes value from the given address start, and up to $size bytes of
         // $value
         for (int i = 0; i < bytes; i++) {
@@ -73,6 +78,40 @@ public:
 
     void clearInitializationMemories() { m_initializationMemories.clear(); }
 
+    /**
+     * @brief contents/setContents
+     * The bytes held by the sparse array, ordered by address. Used for snapshots of the owning design; memory mapped
+     * regions are not part of the contents.
+     */
+    std::vector<std::pair<VSRTL_VT_U, uint8_t>> contents() const {
+        std::vector<std::pair<VSRTL_VT_U, uint8_t>> bytes(m_data.begin(), m_data.end());
+        std::sort(bytes.begin(), bytes.end());
+        return bytes;
+    }
+    void setContents(const std::vector<std::pair<VSRTL_VT_U, uint8_t>>& bytes) {
+        m_data.clear();
+        m_data.reserve(bytes.size());
+        m_data.insert(bytes.begin(), bytes.end());
+    }
+
+    /**
+     * @brief addWriteObserver/removeWriteObserver
+     * Adds a function which is called with the address and byte count of each write to the sparse array (ie. not to
+     * memory mapped regions), such as used by breakpoints. Observers are called in order of addition, and are
+     * identified by the returned id for removal.
+     */
+    using WriteObserver = std::function<void(VSRTL_VT_U, int)>;
+    uint32_t addWriteObserver(WriteObserver observer) {
+        m_writeObservers.emplace_back(m_nextObserverId, std::move(observer));
+        return m_nextObserverId++;
+    }
+    void removeWriteObserver(uint32_t id) {
+        auto it = std::find_if(m_writeObservers.begin(), m_writeObservers.end(),
+                               [id](const auto& observer) { return observer.first == id; });
+        assert(it != m_writeObservers.end() && "Tried to remove non-existing write observer");
+        m_writeObservers.erase(it);
+    }
+
     virtual void reset() {
         m_data.clear();
         for (const auto& mem : m_initializationMemories) {
@@ -85,6 +124,8 @@ public:
 private:
     std::unordered_map<VSRTL_VT_U, uint8_t> m_data;
     std::vector<AddressSpace> m_initializationMemories;
+    std::vector<std::pair<uint32_t, WriteObserver>> m_writeObservers;
+    uint32_t m_nextObserverId = 0;
 };
 
 struct IOFunctors {
@@ -24,6 +24,10 @@ public:
 
     void propagate() { calculateOutput(); }
 
+    BatchPrimitive batchPrimitive(const PortBase*) const override {
+        return {BatchPrimitive::Op::alu, {&ctrl, &op1, &op2}, 0};
+    }
+
     INPUTPORT(op1, W);
     INPUTPORT(op2, W);
     INPUTPORT(ctrl, ALU_OPCODE::width());
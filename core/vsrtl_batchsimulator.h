@@ -0,0 +1,447 @@
+#ifndef VSRTL_BATCHSIMULATOR_H
+#define VSRTL_BATCHSIMULATOR_H
+
+#include "../interface/vsrtl_binutils.h"
+#include "../interface/vsrtl_defines.h"
+#include "vsrtl_alu.h"
+#include "vsrtl_design.h"
+
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The BatchSimulator class
+ * Simulates N independent instances (lanes) of a design in lockstep. The design is elaborated once, and each port is
+ * assigned a row of N values in a lane-major value table. Ports of built-in primitives (see
+ * Component::batchPrimitive()) are evaluated by loops over contiguous rows, which compilers vectorize for the SIMD
+ * extensions of the target. Lanes which diverge (ie. differing multiplexer selects) are resolved per lane.
+ * Ports of all other components are evaluated lane by lane: the values of the inputs and sensitivity list of the
+ * component for the given lane are loaded into the value table of the design, after which the propagation function of
+ * the port is called.
+ *
+ * Supported designs contain no stateful components (ie. memories), and all synchronous components are registers with
+ * a depth of 1 (see RegisterBase). All ports are simulated, including those which the design eliminated as unobserved
+ * (see Design::setEliminateUnobservedPorts()). While in use by a BatchSimulator, the port values of the design itself
+ * are undefined.
+ */
+class BatchSimulator {
+public:
+    /**
+     * @brief BatchSimulator
+     * Creates a batch simulator for @p design, in which all lanes have been reset.
+     * @param design: a verified and initialized design.
+     * @param lanes: number of instances of the design to simulate.
+     * @throws std::runtime_error if the design contains components which cannot be simulated in batch.
+     */
+    BatchSimulator(Design& design, unsigned lanes) : m_lanes(lanes) {
+        if (!design.isVerifiedAndInitialized()) {
+            throw std::runtime_error("Design was not verified and initialized before batch simulation.");
+        }
+        if (lanes == 0) {
+            throw std::runtime_error("Batch simulation requires at least one lane");
+        }
+
+        m_scalarValues = design.m_portValues.data();
+        const size_t nSlots = design.m_portValues.size();
+        m_values.resize(nSlots * m_lanes);
+        for (size_t slot = 0; slot < nSlots; slot++) {
+            for (unsigned lane = 0; lane < m_lanes; lane++)
+                row(slot)[lane] = m_scalarValues[slot];
+        }
+
+        for (const auto& comp : design.m_components) {
+            if (comp->isStateful()) {
+                throw std::runtime_error("Component '" + comp->getHierName() +
+                                         "' is stateful and cannot be simulated in batch");
+            }
+            if (comp->isSynchronous()) {
+                auto* reg = dynamic_cast<RegisterBase*>(comp);
+                if (!reg || reg->depth() != 1) {
+                    throw std::runtime_error("Synchronous component '" + comp->getHierName() +
+                                             "' cannot be simulated in batch");
+                }
+                addRegister(reg);
+            }
+        }
+        m_state.resize(m_registers.size() * m_lanes);
+
+        // Ports eliminated by Design::setEliminateUnobservedPorts() only depend on the stack and on each other
+        for (const auto* ports : {&design.m_propagationStack, &design.m_unobservedPorts}) {
+            for (const auto& port : *ports)
+                m_tape.push_back(lower(port));
+        }
+        reset();
+    }
+
+    unsigned laneCount() const { return m_lanes; }
+    long long getCycleCount() const { return m_cycleCount; }
+
+    /**
+     * @brief reset
+     * Resets all lanes, loading all registers with their initial value, and propagates the design.
+     */
+    void reset() {
+        for (size_t r = 0; r < m_registers.size(); r++) {
+            for (unsigned lane = 0; lane < m_lanes; lane++)
+                m_state[r * m_lanes + lane] = m_registers[r].init;
+        }
+        m_cycleCount = 0;
+        propagate();
+    }
+
+    /**
+     * @brief clock
+     * Clocks the registers of all lanes and propagates the design.
+     */
+    void clock() {
+        for (size_t r = 0; r < m_registers.size(); r++) {
+            const auto& reg = m_registers[r];
+            VSRTL_VT_U* state = &m_state[r * m_lanes];
+            const VSRTL_VT_U* in = row(reg.in);
+            if (reg.enable == s_noSlot) {
+                for (unsigned lane = 0; lane < m_lanes; lane++)
+                    state[lane] = in[lane];
+            } else {
+                const VSRTL_VT_U* enable = row(reg.enable);
+                const VSRTL_VT_U* clear = row(reg.clear);
+                for (unsigned lane = 0; lane < m_lanes; lane++) {
+                    const VSRTL_VT_U next = clear[lane] ? 0 : in[lane];
+                    state[lane] = enable[lane] ? next : state[lane];
+                }
+            }
+        }
+        m_cycleCount++;
+        propagate();
+    }
+
+    void propagate() {
+        for (const auto& instr : m_tape)
+            execute(instr);
+    }
+
+    /**
+     * @brief setRegisterValue
+     * Forces the value of register @p reg in lane @p lane. The design should subsequently be propagated.
+     */
+    void setRegisterValue(RegisterBase* reg, unsigned lane, VSRTL_VT_U value) {
+        auto it = m_registerIndex.find(reg);
+        if (it == m_registerIndex.end()) {
+            throw std::runtime_error("Register is not part of the batch simulated design");
+        }
+        m_state[it->second * m_lanes + lane] = value;
+    }
+
+    VSRTL_VT_U value(const PortBase* port, unsigned lane) const {
+        return row(slotOf(port))[lane] & generateBitmask(port->getWidth());
+    }
+
+private:
+    using Op = Component::BatchPrimitive::Op;
+    static constexpr uint32_t s_noSlot = UINT32_MAX;
+
+    enum class Kind { copy, call, reg, primitive };
+
+    struct Instruction {
+        Kind kind;
+        Op op;
+        uint32_t dst;
+        VSRTL_VT_U mask;
+        VSRTL_VT_U immediate;
+        /// Operand slots of primitives, source slot of copies, register index of register outputs.
+        std::vector<uint32_t> operands;
+        std::vector<unsigned> operandWidths;
+        /// Slots which are loaded into the value table of the design prior to calling the propagation function.
+        std::vector<uint32_t> inputs;
+        const PropagationFunction* function;
+    };
+
+    struct Register {
+        uint32_t in;
+        uint32_t enable;
+        uint32_t clear;
+        VSRTL_VT_U init;
+    };
+
+    VSRTL_VT_U* row(size_t slot) { return &m_values[slot * m_lanes]; }
+    const VSRTL_VT_U* row(size_t slot) const { return &m_values[slot * m_lanes]; }
+    uint32_t slotOf(const PortBase* port) const { return static_cast<uint32_t>(port->valueSlot() - m_scalarValues); }
+
+    void addRegister(RegisterBase* reg) {
+        m_registerIndex[reg] = static_cast<uint32_t>(m_registers.size());
+        m_registerOutputs[reg->getOut()] = static_cast<uint32_t>(m_registers.size());
+        Register r;
+        r.in = slotOf(reg->getIn());
+        r.enable = reg->getEnable() ? slotOf(reg->getEnable()) : s_noSlot;
+        r.clear = reg->getClear() ? slotOf(reg->getClear()) : s_noSlot;
+        r.init = reg->getInitValue();
+        m_registers.push_back(r);
+    }
+
+    Instruction lower(PortBase* port) {
+        Instruction instr;
+        instr.kind = Kind::call;
+        instr.op = Op::none;
+        instr.dst = slotOf(port);
+        instr.mask = generateBitmask(port->getWidth());
+        instr.immediate = 0;
+        instr.function = port->hasPropagationFunction() ? &port->getPropagationFunction() : nullptr;
+
+        if (!port->hasPropagationFunction()) {
+            instr.kind = Kind::copy;
+            instr.operands = {slotOf(port->getInputPort<PortBase>())};
+            return instr;
+        }
+
+        auto regIt = m_registerOutputs.find(port);
+        if (regIt != m_registerOutputs.end()) {
+            instr.kind = Kind::reg;
+            instr.operands = {regIt->second};
+            return instr;
+        }
+
+        auto* parent = port->getParent<Component>();
+        for (const auto& in : parent->getInputPorts<PortBase>())
+            instr.inputs.push_back(slotOf(in));
+        for (const auto& sens : parent->getSensitivityList())
+            instr.inputs.push_back(slotOf(sens));
+
+        const auto primitive = parent->batchPrimitive(port);
+        if (primitive.op != Op::none) {
+            instr.kind = Kind::primitive;
+            instr.op = primitive.op;
+            instr.immediate = primitive.immediate;
+            for (const auto& operand : primitive.operands) {
+                instr.operands.push_back(slotOf(operand));
+                instr.operandWidths.push_back(operand->getWidth());
+            }
+        }
+        return instr;
+    }
+
+    /**
+     * @brief callLane
+     * Evaluates @p instr for a single lane through the propagation function of the port.
+     */
+    void callLane(const Instruction& instr, unsigned lane) {
+        for (const auto& slot : instr.inputs)
+            m_scalarValues[slot] = row(slot)[lane];
+        row(instr.dst)[lane] = (*instr.function)() & instr.mask;
+    }
+
+    void execute(const Instruction& instr) {
+        VSRTL_VT_U* dst = row(instr.dst);
+        const VSRTL_VT_U mask = instr.mask;
+        const unsigned n = m_lanes;
+
+        switch (instr.kind) {
+            case Kind::copy: {
+                const VSRTL_VT_U* src = row(instr.operands[0]);
+                for (unsigned l = 0; l < n; l++)
+                    dst[l] = src[l] & mask;
+                return;
+            }
+            case Kind::reg: {
+                const VSRTL_VT_U* state = &m_state[instr.operands[0] * n];
+                for (unsigned l = 0; l < n; l++)
+                    dst[l] = state[l] & mask;
+                return;
+            }
+            case Kind::call: {
+                for (unsigned l = 0; l < n; l++)
+                    callLane(instr, l);
+                return;
+            }
+            case Kind::primitive:
+                executePrimitive(instr, dst);
+                return;
+        }
+    }
+
+    void executePrimitive(const Instruction& instr, VSRTL_VT_U* dst) {
+        const VSRTL_VT_U mask = instr.mask;
+        const unsigned n = m_lanes;
+        const auto& ops = instr.operands;
+
+        switch (instr.op) {
+            case Op::constant: {
+                const VSRTL_VT_U v = instr.immediate & mask;
+                for (unsigned l = 0; l < n; l++)
+                    dst[l] = v;
+                return;
+            }
+            case Op::bitAnd:
+            case Op::bitNand:
+            case Op::bitOr:
+            case Op::bitXor: {
+                const VSRTL_VT_U* a = row(ops[0]);
+                for (unsigned l = 0; l < n; l++)
+                    dst[l] = a[l];
+                for (size_t i = 1; i < ops.size(); i++) {
+                    const VSRTL_VT_U* b = row(ops[i]);
+                    if (instr.op == Op::bitOr) {
+                        for (unsigned l = 0; l < n; l++)
+                            dst[l] |= b[l];
+                    } else if (instr.op == Op::bitXor) {
+                        for (unsigned l = 0; l < n; l++)
+                            dst[l] ^= b[l];
+                    } else {
+                        for (unsigned l = 0; l < n; l++)
+                            dst[l] &= b[l];
+                    }
+                }
+                const VSRTL_VT_U invert = instr.op == Op::bitNand ? ~VSRTL_VT_U(0) : 0;
+                for (unsigned l = 0; l < n; l++)
+                    dst[l] = (dst[l] ^ invert) & mask;
+                return;
+            }
+            case Op::bitNot: {
+                const VSRTL_VT_U* a = row(ops[0]);
+                for (unsigned l = 0; l < n; l++)
+                    dst[l] = ~a[l] & mask;
+                return;
+            }
+            case Op::add: {
+                const VSRTL_VT_U* a = row(ops[0]);
+                const VSRTL_VT_U* b = row(ops[1]);
+                for (unsigned l = 0; l < n; l++)
+                    dst[l] = (a[l] + b[l]) & mask;
+                return;
+            }
+            case Op::shl:
+            case Op::shr:
+            case Op::sra: {
+                const VSRTL_VT_U* a = row(ops[0]);
+                const unsigned shamt = static_cast<unsigned>(instr.immediate);
+                const unsigned width = instr.operandWidths[0];
+                if (instr.op == Op::shl) {
+                    for (unsigned l = 0; l < n; l++)
+                        dst[l] = (a[l] << shamt) & mask;
+                } else if (instr.op == Op::shr) {
+                    for (unsigned l = 0; l < n; l++)
+                        dst[l] = (a[l] >> shamt) & mask;
+                } else {
+                    for (unsigned l = 0; l < n; l++)
+                        dst[l] = VT_U(signextend<VSRTL_VT_U>(a[l], width) >> shamt) & mask;
+                }
+                return;
+            }
+            case Op::mux: {
+                const VSRTL_VT_U* sel = row(ops[0]);
+                const size_t nInputs = ops.size() - 1;
+                if (nInputs <= s_maxBlendInputs) {
+                    // Branchless selection across all lanes
+                    for (unsigned l = 0; l < n; l++)
+                        dst[l] = 0;
+                    for (size_t i = 0; i < nInputs; i++) {
+                        const VSRTL_VT_U* in = row(ops[i + 1]);
+                        for (unsigned l = 0; l < n; l++)
+                            dst[l] = sel[l] == i ? in[l] : dst[l];
+                    }
+                    for (unsigned l = 0; l < n; l++)
+                        dst[l] &= mask;
+                } else {
+                    for (unsigned l = 0; l < n; l++) {
+                        if (sel[l] < nInputs)
+                            dst[l] = row(ops[sel[l] + 1])[l] & mask;
+                    }
+                }
+                // Out-of-range selects are handled by the propagation function (which throws)
+                for (unsigned l = 0; l < n; l++) {
+                    if (sel[l] >= nInputs)
+                        callLane(instr, l);
+                }
+                return;
+            }
+            case Op::alu:
+                executeALU(instr, dst);
+                return;
+            case Op::collate: {
+                for (unsigned l = 0; l < n; l++)
+                    dst[l] = 0;
+                for (size_t i = 0; i < ops.size(); i++) {
+                    const VSRTL_VT_U* in = row(ops[i]);
+                    for (unsigned l = 0; l < n; l++)
+                        dst[l] |= (in[l] & 0b1) << i;
+                }
+                for (unsigned l = 0; l < n; l++)
+                    dst[l] &= mask;
+                return;
+            }
+            case Op::none:
+                return;
+        }
+    }
+
+    void executeALU(const Instruction& instr, VSRTL_VT_U* dst) {
+        const VSRTL_VT_U* ctrl = row(instr.operands[0]);
+        const VSRTL_VT_U* op1 = row(instr.operands[1]);
+        const VSRTL_VT_U* op2 = row(instr.operands[2]);
+        const unsigned w1 = instr.operandWidths[1];
+        const unsigned w2 = instr.operandWidths[2];
+
+        for (unsigned l = 0; l < m_lanes; l++) {
+            const VSRTL_VT_U a = op1[l];
+            const VSRTL_VT_U b = op2[l];
+            VSRTL_VT_U r;
+            switch (ctrl[l]) {
+                case ALU_OPCODE::ADD:
+                    r = a + b;
+                    break;
+                case ALU_OPCODE::SUB:
+                    r = a - b;
+                    break;
+                case ALU_OPCODE::MUL:
+                    r = a * b;
+                    break;
+                case ALU_OPCODE::AND:
+                    r = a & b;
+                    break;
+                case ALU_OPCODE::OR:
+                    r = a | b;
+                    break;
+                case ALU_OPCODE::XOR:
+                    r = a ^ b;
+                    break;
+                case ALU_OPCODE::LUI:
+                    r = b;
+                    break;
+                case ALU_OPCODE::LT:
+                    r = signextend<VSRTL_VT_U>(a, w1) < signextend<VSRTL_VT_U>(b, w2) ? 1 : 0;
+                    break;
+                case ALU_OPCODE::LTU:
+                    r = a < b ? 1 : 0;
+                    break;
+                default:
+                    // Division, shifts and invalid opcodes may be undefined or throw for some operands; these are
+                    // evaluated by the propagation function of the ALU.
+                    callLane(instr, l);
+                    continue;
+            }
+            dst[l] = r & instr.mask;
+        }
+    }
+
+    static constexpr size_t s_maxBlendInputs = 8;
+
+    unsigned m_lanes;
+    long long m_cycleCount = 0;
+
+    VSRTL_VT_U* m_scalarValues = nullptr;
+    std::vector<VSRTL_VT_U> m_values;
+    std::vector<Instruction> m_tape;
+
+    std::vector<Register> m_registers;
+    std::vector<VSRTL_VT_U> m_state;
+    std::map<const RegisterBase*, uint32_t> m_registerIndex;
+    std::map<const PortBase*, uint32_t> m_registerOutputs;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_BATCHSIMULATOR_H
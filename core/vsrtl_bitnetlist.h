@@ -0,0 +1,574 @@
+#ifndef VSRTL_BITNETLIST_H
+#define VSRTL_BITNETLIST_H
+
+#include "../interface/vsrtl_defines.h"
+#include "vsrtl_component.h"
+#include "vsrtl_flatnetlist.h"
+#include "vsrtl_port.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The BitNetlist class
+ * Gate-level evaluation of the 1-bit logic of a design. Clusters of 1-bit logic gates (see Component::batchPrimitive())
+ * are packed such that the values of up to 64 independent nets are held in a single word, and 64 gates of the same
+ * kind are evaluated by a single bitwise instruction.
+ *
+ * A net is a 1-bit gate output together with all ports which copy its value. Single bits extracted from wider values
+ * (ie. Decollator outputs) are loaded into packed words, and wider values assembled from single bits (ie. Collator
+ * outputs) are assembled directly from packed words. Operands of gates which are located at different bit positions
+ * are aligned through rotate-and-mask moves, which are merged such that a single move relocates all bits sharing the
+ * same source word and rotation.
+ *
+ * Any remaining ports are executed as flat netlist instructions. The propagation stack is split into segments; each
+ * segment executes flat instructions followed by a block of packed evaluation, such that packed nets are evaluated
+ * once all of their flat dependencies have been evaluated, and vice versa. After a block has been evaluated, the values
+ * of all of its nets are written back to the value table of the design, and so all ports remain observable.
+ */
+class BitNetlist {
+public:
+    enum class OpCode : uint8_t {
+        clear,       // words[dst] = 0
+        gather,      // words[dst] |= rotl(values[src], rot) & mask
+        move,        // words[dst] |= rotl(words[src], rot) & mask
+        assign,      // words[dst] = words[src]
+        bitAnd,      // words[dst] &= words[src]
+        bitOr,       // words[dst] |= words[src]
+        bitXor,      // words[dst] ^= words[src]
+        invert,      // words[dst] = ~words[dst]
+        clearValue,  // values[dst] = 0
+        pack         // values[dst] |= rotl(words[src], rot) & mask
+    };
+
+    struct Op {
+        OpCode code;
+        uint8_t rot;
+        uint32_t dst;
+        uint32_t src;
+        VSRTL_VT_U mask;
+    };
+
+    /// Writes bit @p bit of word @p word back to value table slot @p slot.
+    struct Scatter {
+        uint32_t slot;
+        uint32_t word;
+        uint32_t bit;
+    };
+
+    /**
+     * @brief lower
+     * Generates the segments for @p propagationStack. Ports must have been relocated to slots within @p values, with
+     * ports of the propagation stack occupying the first slots in propagation order.
+     * @param dependencies: for each port of the propagation stack, the indices of the ports which must be evaluated
+     * before it.
+     */
+    void lower(const std::vector<PortBase*>& propagationStack, VSRTL_VT_U* values,
+               const std::vector<std::vector<uint32_t>>& dependencies) {
+        m_values = values;
+        m_segments.clear();
+        m_nWords = 0;
+        m_gateCount = 0;
+
+        const uint32_t n = static_cast<uint32_t>(propagationStack.size());
+        classify(propagationStack);
+
+        if (m_gateCount == 0) {
+            // No 1-bit logic to pack; the design is executed as a flat netlist
+            std::fill(m_kinds.begin(), m_kinds.end(), Kind::flat);
+        }
+
+        // A flat port which reads a packed net must be evaluated in a segment following the block evaluating the net
+        std::vector<uint32_t> phases(n, 0);
+        uint32_t nPhases = n == 0 ? 0 : 1;
+        for (uint32_t i = 0; i < n; i++) {
+            const bool packed = m_kinds[i] != Kind::flat;
+            for (const auto& dep : dependencies[i]) {
+                const bool depPacked = m_kinds[dep] != Kind::flat;
+                phases[i] = std::max(phases[i], phases[dep] + (depPacked && !packed ? 1 : 0));
+            }
+            nPhases = std::max(nPhases, phases[i] + 1);
+        }
+
+        m_segments.resize(nPhases);
+        std::vector<std::vector<uint32_t>> members(nPhases);
+        for (uint32_t i = 0; i < n; i++) {
+            if (m_kinds[i] == Kind::flat) {
+                m_segments[phases[i]].instructions.push_back(flatInstruction(propagationStack[i]));
+            } else if (m_kinds[i] == Kind::alias) {
+                m_nets[m_netOfSlot[i]].ports.push_back(i);
+            } else {
+                members[phases[i]].push_back(i);
+            }
+        }
+
+        m_gateCount = 0;
+        for (uint32_t phase = 0; phase < nPhases; phase++) {
+            if (!buildBlock(m_segments[phase], members[phase]))
+                unpackBlock(m_segments[phase], members[phase], propagationStack);
+        }
+        m_words.assign(m_nWords, 0);
+
+        // Discard elaboration state
+        m_kinds.clear();
+        m_operands.clear();
+        m_netOfSlot.clear();
+        m_leafNets.clear();
+        m_nets.clear();
+        m_placed.clear();
+        m_gateOps.clear();
+    }
+
+    void execute() {
+        VSRTL_VT_U* const values = m_values;
+        VSRTL_VT_U* const words = m_words.data();
+        for (const auto& segment : m_segments) {
+            for (const auto& instr : segment.instructions)
+                FlatNetlist::execute(instr, values);
+            for (const auto& op : segment.ops)
+                execute(op, values, words);
+            for (const auto& s : segment.scatters)
+                values[s.slot] = (words[s.word] >> s.bit) & 0b1;
+        }
+    }
+
+    bool isLowered() const { return m_values != nullptr; }
+
+    /// Number of gates evaluated in packed form.
+    size_t gateCount() const { return m_gateCount; }
+    /// Number of packed words.
+    size_t wordCount() const { return m_words.size(); }
+    size_t segmentCount() const { return m_segments.size(); }
+    /// Number of bitwise operations executed per propagation, excluding write-backs to the value table.
+    size_t opCount() const {
+        size_t count = 0;
+        for (const auto& segment : m_segments)
+            count += segment.ops.size();
+        return count;
+    }
+
+private:
+    using PrimitiveOp = Component::BatchPrimitive::Op;
+    enum class Kind : uint8_t { flat, gate, extract, alias, collate };
+
+    struct Segment {
+        std::vector<FlatNetlist::Instruction> instructions;
+        std::vector<Op> ops;
+        std::vector<Scatter> scatters;
+    };
+
+    struct Net {
+        static constexpr uint32_t s_unplaced = UINT32_MAX;
+        uint32_t word = s_unplaced;
+        uint32_t bit = 0;
+        /// Value table slot from which the net is loaded (leaf nets and extracted bits).
+        uint32_t source = 0;
+        uint32_t sourceBit = 0;
+        bool isLeaf = false;
+        /// Value table slots of the ports of the net (in propagation order), written back once the net has been
+        /// evaluated.
+        std::vector<uint32_t> ports;
+    };
+
+    static constexpr unsigned s_wordBits = 64;
+    static constexpr uint32_t s_noNet = UINT32_MAX;
+
+    static VSRTL_VT_U rotl(VSRTL_VT_U v, unsigned r) { return r == 0 ? v : (v << r) | (v >> (s_wordBits - r)); }
+
+    static void execute(const Op& op, VSRTL_VT_U* values, VSRTL_VT_U* words) {
+        switch (op.code) {
+            case OpCode::clear:
+                words[op.dst] = 0;
+                break;
+            case OpCode::gather:
+                words[op.dst] |= rotl(values[op.src], op.rot) & op.mask;
+                break;
+            case OpCode::move:
+                words[op.dst] |= rotl(words[op.src], op.rot) & op.mask;
+                break;
+            case OpCode::assign:
+                words[op.dst] = words[op.src];
+                break;
+            case OpCode::bitAnd:
+                words[op.dst] &= words[op.src];
+                break;
+            case OpCode::bitOr:
+                words[op.dst] |= words[op.src];
+                break;
+            case OpCode::bitXor:
+                words[op.dst] ^= words[op.src];
+                break;
+            case OpCode::invert:
+                words[op.dst] = ~words[op.dst];
+                break;
+            case OpCode::clearValue:
+                values[op.dst] = 0;
+                break;
+            case OpCode::pack:
+                values[op.dst] |= rotl(words[op.src], op.rot) & op.mask;
+                break;
+        }
+    }
+
+    uint32_t slotOf(const PortBase* port) const { return static_cast<uint32_t>(port->valueSlot() - m_values); }
+
+    FlatNetlist::Instruction flatInstruction(PortBase* port) const {
+        FlatNetlist::Instruction instr;
+        instr.dst = slotOf(port);
+        instr.mask = generateBitmask(port->getWidth());
+        instr.function = nullptr;
+        instr.src = 0;
+        if (port->hasPropagationFunction()) {
+            instr.code = FlatNetlist::OpCode::call;
+            instr.function = &port->getPropagationFunction();
+        } else {
+            instr.code = FlatNetlist::OpCode::copy;
+            instr.src = slotOf(port->getInputPort<PortBase>());
+        }
+        return instr;
+    }
+
+    /**
+     * @brief netOf
+     * Returns the net carrying the value of 1-bit port @p port. Ports which are not part of a packed net are leaves,
+     * which are loaded from the value table by the blocks reading them.
+     */
+    uint32_t netOf(const PortBase* port) {
+        const uint32_t slot = slotOf(port);
+        if (slot < m_netOfSlot.size() && m_netOfSlot[slot] != s_noNet)
+            return m_netOfSlot[slot];
+
+        // Copies of a leaf are resolved to the port which computes the value
+        auto* root = const_cast<PortBase*>(port);
+        while (!root->hasPropagationFunction() && root->getInputPort<PortBase>())
+            root = root->getInputPort<PortBase>();
+        const uint32_t rootSlot = slotOf(root);
+        auto it = m_leafNets.find(rootSlot);
+        if (it != m_leafNets.end())
+            return it->second;
+
+        Net net;
+        net.isLeaf = true;
+        net.source = rootSlot;
+        m_nets.push_back(net);
+        m_leafNets[rootSlot] = static_cast<uint32_t>(m_nets.size() - 1);
+        return static_cast<uint32_t>(m_nets.size() - 1);
+    }
+
+    uint32_t createNet(uint32_t slot) {
+        Net net;
+        net.ports.push_back(slot);
+        m_nets.push_back(net);
+        m_netOfSlot[slot] = static_cast<uint32_t>(m_nets.size() - 1);
+        return m_netOfSlot[slot];
+    }
+
+    void classify(const std::vector<PortBase*>& propagationStack) {
+        const uint32_t n = static_cast<uint32_t>(propagationStack.size());
+        m_kinds.assign(n, Kind::flat);
+        m_operands.assign(n, {});
+        m_netOfSlot.assign(n, s_noNet);
+        m_gateOps.assign(n, PrimitiveOp::none);
+
+        for (uint32_t i = 0; i < n; i++) {
+            PortBase* port = propagationStack[i];
+            if (!port->hasPropagationFunction()) {
+                const uint32_t src = slotOf(port->getInputPort<PortBase>());
+                if (port->getWidth() == 1 && src < n && m_netOfSlot[src] != s_noNet) {
+                    m_kinds[i] = Kind::alias;
+                    m_netOfSlot[i] = m_netOfSlot[src];
+                }
+                continue;
+            }
+
+            auto* parent = port->getParent<Component>();
+            if (!parent)
+                continue;
+            const auto primitive = parent->batchPrimitive(port);
+            switch (primitive.op) {
+                case PrimitiveOp::bitAnd:
+                case PrimitiveOp::bitNand:
+                case PrimitiveOp::bitOr:
+                case PrimitiveOp::bitXor:
+                case PrimitiveOp::bitNot: {
+                    if (port->getWidth() != 1)
+                        break;
+                    m_kinds[i] = Kind::gate;
+                    m_gateOps[i] = primitive.op;
+                    for (const auto& operand : primitive.operands)
+                        m_operands[i].push_back(netOf(operand));
+                    createNet(i);
+                    m_gateCount++;
+                    break;
+                }
+                case PrimitiveOp::shr: {
+                    if (port->getWidth() != 1 || primitive.immediate >= s_wordBits)
+                        break;
+                    m_kinds[i] = Kind::extract;
+                    const uint32_t net = createNet(i);
+                    m_nets[net].source = slotOf(primitive.operands[0]);
+                    m_nets[net].sourceBit = static_cast<uint32_t>(primitive.immediate);
+                    break;
+                }
+                case PrimitiveOp::collate: {
+                    m_kinds[i] = Kind::collate;
+                    for (const auto& operand : primitive.operands)
+                        m_operands[i].push_back(netOf(operand));
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    }
+
+    uint32_t allocateWord() { return m_nWords++; }
+
+    /**
+     * @brief placeLoads
+     * Assigns packed positions to the nets in @p nets which are loaded from the value table, and emits the gathers
+     * loading them. Bits extracted from the same source slot at consecutive positions are loaded by a single gather.
+     */
+    void placeLoads(Segment& segment, const std::vector<uint32_t>& nets) {
+        std::map<std::tuple<uint32_t, uint32_t, unsigned>, VSRTL_VT_U> gathers;
+        uint32_t word = 0;
+        unsigned bit = s_wordBits;
+        for (const auto& id : nets) {
+            Net& net = m_nets[id];
+            if (net.word != Net::s_unplaced)
+                continue;
+            if (bit == s_wordBits) {
+                word = allocateWord();
+                bit = 0;
+                segment.ops.push_back({OpCode::clear, 0, word, 0, 0});
+            }
+            net.word = word;
+            net.bit = bit++;
+            m_placed.push_back(id);
+            const unsigned rot = (net.bit - net.sourceBit + s_wordBits) % s_wordBits;
+            gathers[{word, net.source, rot}] |= VSRTL_VT_U(1) << net.bit;
+        }
+        for (const auto& g : gathers) {
+            const auto& [dst, src, rot] = g.first;
+            segment.ops.push_back({OpCode::gather, static_cast<uint8_t>(rot), dst, src, g.second});
+        }
+    }
+
+    /**
+     * @brief alignOperand
+     * Returns a word holding the values of @p nets at bit positions 0..nets.size()-1, emitting the moves required to
+     * assemble it.
+     */
+    uint32_t alignOperand(Segment& segment, const std::vector<uint32_t>& nets) {
+        std::map<std::pair<uint32_t, unsigned>, VSRTL_VT_U> moves;
+        for (unsigned j = 0; j < nets.size(); j++) {
+            const Net& net = m_nets[nets[j]];
+            moves[{net.word, (j - net.bit + s_wordBits) % s_wordBits}] |= VSRTL_VT_U(1) << j;
+        }
+        const VSRTL_VT_U used = nets.size() == s_wordBits ? ~VSRTL_VT_U(0) : (VSRTL_VT_U(1) << nets.size()) - 1;
+        if (moves.size() == 1 && moves.begin()->first.second == 0 && moves.begin()->second == used) {
+            // Operands are already aligned within a single word
+            return moves.begin()->first.first;
+        }
+
+        const uint32_t word = allocateWord();
+        segment.ops.push_back({OpCode::clear, 0, word, 0, 0});
+        for (const auto& m : moves) {
+            segment.ops.push_back(
+                {OpCode::move, static_cast<uint8_t>(m.first.second), word, m.first.first, m.second});
+        }
+        return word;
+    }
+
+    /**
+     * @brief buildBlock
+     * Emits the packed evaluation of @p members into @p segment. Packing is rejected if the gates of the block cannot
+     * be evaluated in fewer operations than there are gates (ie. narrow chains of logic, where aligning operands
+     * outweighs the gain of packing).
+     * @returns whether the block was packed.
+     */
+    bool buildBlock(Segment& segment, const std::vector<uint32_t>& members) {
+        if (members.empty())
+            return true;
+
+        const uint32_t firstWord = m_nWords;
+        m_placed.clear();
+        Segment block;
+        size_t gates = 0;
+        for (const auto& i : members)
+            gates += m_kinds[i] == Kind::gate ? 1 : 0;
+
+        // Load extracted bits and leaves read by the block
+        std::vector<uint32_t> loads;
+        for (const auto& i : members) {
+            if (m_kinds[i] == Kind::extract)
+                loads.push_back(m_netOfSlot[i]);
+        }
+        for (const auto& i : members) {
+            for (const auto& net : m_operands[i]) {
+                if (m_nets[net].isLeaf)
+                    loads.push_back(net);
+            }
+        }
+        placeLoads(block, loads);
+
+        // Gates are levelized within the block; gates of a level are independent, and are packed by kind
+        std::unordered_map<uint32_t, uint32_t> levelOf;
+        std::vector<std::vector<uint32_t>> levels;
+        for (const auto& i : members) {
+            if (m_kinds[i] != Kind::gate)
+                continue;
+            uint32_t level = 0;
+            for (const auto& net : m_operands[i]) {
+                auto it = levelOf.find(net);
+                if (it != levelOf.end())
+                    level = std::max(level, it->second + 1);
+            }
+            levelOf[m_netOfSlot[i]] = level;
+            if (levels.size() <= level)
+                levels.resize(level + 1);
+            levels[level].push_back(i);
+        }
+
+        for (auto& level : levels) {
+            std::map<std::pair<PrimitiveOp, size_t>, std::vector<uint32_t>> kinds;
+            for (const auto& i : level)
+                kinds[{m_gateOps[i], m_operands[i].size()}].push_back(i);
+
+            for (auto& kind : kinds) {
+                auto& gates = kind.second;
+                // Placing gates in the order of their first operand aligns gates with the nets which they read
+                std::stable_sort(gates.begin(), gates.end(), [&](uint32_t a, uint32_t b) {
+                    const Net& na = m_nets[m_operands[a][0]];
+                    const Net& nb = m_nets[m_operands[b][0]];
+                    return std::make_pair(na.word, na.bit) < std::make_pair(nb.word, nb.bit);
+                });
+                for (size_t first = 0; first < gates.size(); first += s_wordBits)
+                    packGates(block, kind.first.first, gates, first,
+                              std::min(gates.size(), first + s_wordBits));
+            }
+        }
+
+        for (const auto& i : members) {
+            if (m_kinds[i] != Kind::collate)
+                continue;
+            std::map<std::pair<uint32_t, unsigned>, VSRTL_VT_U> packs;
+            for (unsigned j = 0; j < m_operands[i].size(); j++) {
+                const Net& net = m_nets[m_operands[i][j]];
+                packs[{net.word, (j - net.bit + s_wordBits) % s_wordBits}] |= VSRTL_VT_U(1) << j;
+            }
+            block.ops.push_back({OpCode::clearValue, 0, i, 0, 0});
+            for (const auto& p : packs)
+                block.ops.push_back({OpCode::pack, static_cast<uint8_t>(p.first.second), i, p.first.first, p.second});
+        }
+
+        for (const auto& i : members) {
+            if (m_kinds[i] != Kind::gate && m_kinds[i] != Kind::extract)
+                continue;
+            const Net& net = m_nets[m_netOfSlot[i]];
+            for (const auto& slot : net.ports)
+                block.scatters.push_back({slot, net.word, net.bit});
+        }
+
+        if (block.ops.size() >= gates) {
+            m_nWords = firstWord;
+            for (const auto& id : m_placed)
+                m_nets[id].word = Net::s_unplaced;
+            return false;
+        }
+        m_gateCount += gates;
+        segment.ops.insert(segment.ops.end(), block.ops.begin(), block.ops.end());
+        segment.scatters.insert(segment.scatters.end(), block.scatters.begin(), block.scatters.end());
+        return true;
+    }
+
+    /**
+     * @brief unpackBlock
+     * Executes the ports of a rejected block as flat instructions following the flat instructions of its segment. The
+     * nets of the block become leaves of subsequent blocks.
+     */
+    void unpackBlock(Segment& segment, const std::vector<uint32_t>& members,
+                     const std::vector<PortBase*>& propagationStack) {
+        std::vector<uint32_t> ports;
+        for (const auto& i : members) {
+            if (m_kinds[i] == Kind::gate || m_kinds[i] == Kind::extract) {
+                Net& net = m_nets[m_netOfSlot[i]];
+                net.isLeaf = true;
+                net.source = i;
+                net.sourceBit = 0;
+                ports.insert(ports.end(), net.ports.begin(), net.ports.end());
+            } else {
+                ports.push_back(i);
+            }
+        }
+        std::sort(ports.begin(), ports.end());
+        for (const auto& i : ports)
+            segment.instructions.push_back(flatInstruction(propagationStack[i]));
+    }
+
+    /// The word operation which combines the operands of gates of type @p op; inverting gates are inverted after.
+    static OpCode wordOpCode(PrimitiveOp op) {
+        switch (op) {
+            case PrimitiveOp::bitOr:
+                return OpCode::bitOr;
+            case PrimitiveOp::bitXor:
+                return OpCode::bitXor;
+            default:
+                return OpCode::bitAnd;
+        }
+    }
+
+    void packGates(Segment& segment, PrimitiveOp op, const std::vector<uint32_t>& gates, size_t first, size_t last) {
+        const size_t arity = m_operands[gates[first]].size();
+        std::vector<uint32_t> operandWords;
+        for (size_t a = 0; a < arity; a++) {
+            std::vector<uint32_t> nets;
+            for (size_t g = first; g < last; g++)
+                nets.push_back(m_operands[gates[g]][a]);
+            operandWords.push_back(alignOperand(segment, nets));
+        }
+
+        const uint32_t out = allocateWord();
+        segment.ops.push_back({OpCode::assign, 0, out, operandWords[0], 0});
+        const OpCode code = wordOpCode(op);
+        for (size_t a = 1; a < arity; a++)
+            segment.ops.push_back({code, 0, out, operandWords[a], 0});
+        if (op == PrimitiveOp::bitNand || op == PrimitiveOp::bitNot)
+            segment.ops.push_back({OpCode::invert, 0, out, 0, 0});
+
+        for (size_t g = first; g < last; g++) {
+            Net& net = m_nets[m_netOfSlot[gates[g]]];
+            m_placed.push_back(m_netOfSlot[gates[g]]);
+            net.word = out;
+            net.bit = static_cast<uint32_t>(g - first);
+        }
+    }
+
+    VSRTL_VT_U* m_values = nullptr;
+    std::vector<Segment> m_segments;
+    std::vector<VSRTL_VT_U> m_words;
+    uint32_t m_nWords = 0;
+    size_t m_gateCount = 0;
+
+    // Elaboration state
+    std::vector<Kind> m_kinds;
+    std::vector<PrimitiveOp> m_gateOps;
+    std::vector<std::vector<uint32_t>> m_operands;
+    std::vector<uint32_t> m_netOfSlot;
+    std::unordered_map<uint32_t, uint32_t> m_leafNets;
+    std::vector<Net> m_nets;
+    std::vector<uint32_t> m_placed;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_BITNETLIST_H
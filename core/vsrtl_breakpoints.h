@@ -0,0 +1,261 @@
+#ifndef VSRTL_BREAKPOINTS_H
+#define VSRTL_BREAKPOINTS_H
+
+#include "../interface/vsrtl_defines.h"
+#include "vsrtl_addressspace.h"
+#include "vsrtl_port.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The BreakpointEngine class
+ * Evaluates breakpoint conditions on the values of ports (ie. the output of a register), on the contents of address
+ * spaces and on writes to address spaces, once per cycle after the design has been clocked and propagated (see
+ * Design::breakpoints()). Port conditions are compiled into a flat list of comparisons against the value table of the
+ * design; writes are observed through AddressSpace::addWriteObserver(). No work is done while no breakpoints are set.
+ */
+class BreakpointEngine {
+public:
+    BreakpointEngine() = default;
+    BreakpointEngine(const BreakpointEngine&) = delete;
+    BreakpointEngine& operator=(const BreakpointEngine&) = delete;
+    /// Observers are removed from the watched address spaces, which must outlive the engine.
+    ~BreakpointEngine() { clear(); }
+
+    using Id = uint32_t;
+    enum class Compare { eq, ne, lt, le, gt, ge };
+    enum class Trigger {
+        /// Hit in every cycle in which the condition holds.
+        level,
+        /// Hit in the cycles in which the condition starts to hold (ie. a value rising above a threshold).
+        edge
+    };
+
+    /**
+     * @brief addCondition
+     * Breaks when the (unsigned) value of @p port compares as @p compare to @p value.
+     */
+    Id addCondition(const PortBase& port, Compare compare, VSRTL_VT_U value, Trigger trigger = Trigger::level) {
+        Condition condition;
+        condition.port = &port;
+        condition.mask = generateBitmask(port.getWidth());
+        resolve(condition);
+        return insertCondition(condition, compare, value, trigger);
+    }
+
+    /**
+     * @brief addMemoryCondition
+     * Breaks when the (unsigned, little endian) value of the @p bytes bytes starting at @p address within @p memory
+     * compares as @p compare to @p value. Memory mapped regions are not read.
+     */
+    Id addMemoryCondition(const AddressSpace& memory, VSRTL_VT_U address, unsigned bytes, Compare compare,
+                          VSRTL_VT_U value, Trigger trigger = Trigger::level) {
+        if (bytes == 0 || bytes > sizeof(VSRTL_VT_U))
+            throw std::runtime_error("Memory conditions must cover between 1 and " +
+                                     std::to_string(sizeof(VSRTL_VT_U)) + " bytes");
+        Condition condition;
+        condition.memory = &memory;
+        condition.address = address;
+        condition.bytes = bytes;
+        condition.mask = generateBitmask(bytes * CHAR_BIT);
+        return insertCondition(condition, compare, value, trigger);
+    }
+
+    /**
+     * @brief addWriteWatch
+     * Breaks when any of the @p bytes bytes starting at @p address within @p memory is written to by a clocked
+     * component. Writes to memory mapped regions are not observed.
+     */
+    Id addWriteWatch(AddressSpace& memory, VSRTL_VT_U address, unsigned bytes = 1) {
+        if (bytes == 0)
+            throw std::runtime_error("Write watches must cover at least one byte");
+        const Id id = m_nextId++;
+        if (!isWatched(&memory)) {
+            AddressSpace* watched = &memory;
+            const uint32_t observer =
+                memory.addWriteObserver([this, watched](VSRTL_VT_U first, int n) { observeWrite(watched, first, n); });
+            m_observers.push_back({&memory, observer});
+        }
+        m_watches.push_back({&memory, address, address + bytes - 1, id});
+        return id;
+    }
+
+    void remove(Id id) {
+        m_conditions.erase(std::remove_if(m_conditions.begin(), m_conditions.end(),
+                                          [id](const Condition& c) { return c.id == id; }),
+                           m_conditions.end());
+        auto watch = std::find_if(m_watches.begin(), m_watches.end(), [id](const Watch& w) { return w.id == id; });
+        if (watch != m_watches.end()) {
+            AddressSpace* memory = watch->memory;
+            m_watches.erase(watch);
+            if (!isWatched(memory))
+                removeObserver(memory);
+        }
+        m_hits.erase(std::remove(m_hits.begin(), m_hits.end(), id), m_hits.end());
+    }
+
+    void clear() {
+        for (const auto& observer : m_observers)
+            observer.memory->removeWriteObserver(observer.id);
+        m_observers.clear();
+        m_watches.clear();
+        m_conditions.clear();
+        m_hits.clear();
+    }
+
+    bool armed() const { return !m_conditions.empty() || !m_watches.empty(); }
+    /// Whether any condition compares the value of a port, rather than the contents of a memory.
+    bool hasPortConditions() const {
+        return std::any_of(m_conditions.begin(), m_conditions.end(), [](const Condition& c) { return c.port; });
+    }
+
+    /// Breakpoints which were hit in the last clocked cycle, in order of evaluation.
+    const std::vector<Id>& hits() const { return m_hits; }
+    bool hit() const { return !m_hits.empty(); }
+
+    /**
+     * @brief resolve
+     * Resolves the value table slots of all port conditions. Must be called whenever ports have been relocated.
+     */
+    void resolve() {
+        for (auto& condition : m_conditions)
+            resolve(condition);
+    }
+
+    /**
+     * @brief sync
+     * Called by the design when it moves to a cycle other than by clocking (ie. when reversed or reset). No hits are
+     * reported for the new cycle, and edge triggered conditions are rearmed relative to its state.
+     */
+    void sync() {
+        m_hits.clear();
+        for (auto& condition : m_conditions)
+            condition.held = condition.holds();
+    }
+
+    /// Called by the design prior to committing the state of a cycle; writes are observed until evaluate().
+    void beginCycle() {
+        m_hits.clear();
+        m_inCycle = true;
+    }
+
+    /// Called by the design once a cycle has been clocked and propagated.
+    void evaluate() {
+        m_inCycle = false;
+        for (auto& condition : m_conditions) {
+            const bool holds = condition.holds();
+            if (holds && !(condition.edge && condition.held))
+                m_hits.push_back(condition.id);
+            condition.held = holds;
+        }
+    }
+
+private:
+    /// A comparison against either the value of a port, or the contents of a memory.
+    struct Condition {
+        const PortBase* port = nullptr;
+        const VSRTL_VT_U* value = nullptr;
+        const AddressSpace* memory = nullptr;
+        VSRTL_VT_U address = 0;
+        unsigned bytes = 0;
+        VSRTL_VT_U mask;
+        VSRTL_VT_U operand;
+        Compare compare;
+        bool edge;
+        /// Whether the condition held when last evaluated.
+        bool held;
+        Id id;
+
+        bool holds() const {
+            // Memory mapped regions are bypassed, since reading them may affect the peripheral
+            const VSRTL_VT_U v = (memory ? memory->AddressSpace::readMemConst(address, bytes) : *value) & mask;
+            switch (compare) {
+                case Compare::eq:
+                    return v == operand;
+                case Compare::ne:
+                    return v != operand;
+                case Compare::lt:
+                    return v < operand;
+                case Compare::le:
+                    return v <= operand;
+                case Compare::gt:
+                    return v > operand;
+                case Compare::ge:
+                    return v >= operand;
+            }
+            return false;
+        }
+    };
+
+    struct Watch {
+        AddressSpace* memory;
+        VSRTL_VT_U first;
+        VSRTL_VT_U last;
+        Id id;
+    };
+
+    /// A write observer added by the engine to an address space.
+    struct Observer {
+        AddressSpace* memory;
+        uint32_t id;
+    };
+
+    Id insertCondition(Condition& condition, Compare compare, VSRTL_VT_U value, Trigger trigger) {
+        condition.operand = value;
+        condition.compare = compare;
+        condition.edge = trigger == Trigger::edge;
+        condition.id = m_nextId++;
+        // An edge triggered condition which already holds must first cease to hold
+        condition.held = condition.holds();
+        m_conditions.push_back(condition);
+        return condition.id;
+    }
+
+    static void resolve(Condition& condition) {
+        if (condition.port)
+            condition.value = condition.port->valueSlot();
+    }
+
+    bool isWatched(const AddressSpace* memory) const {
+        return std::any_of(m_watches.begin(), m_watches.end(), [memory](const Watch& w) { return w.memory == memory; });
+    }
+
+    void removeObserver(AddressSpace* memory) {
+        auto it = std::find_if(m_observers.begin(), m_observers.end(),
+                               [memory](const Observer& o) { return o.memory == memory; });
+        it->memory->removeWriteObserver(it->id);
+        m_observers.erase(it);
+    }
+
+    void observeWrite(const AddressSpace* memory, VSRTL_VT_U address, int bytes) {
+        // Writes outside of clocking (ie. when reversing or resetting the design) are not breakpoints
+        if (!m_inCycle)
+            return;
+        const VSRTL_VT_U last = address + bytes - 1;
+        for (const auto& watch : m_watches) {
+            if (watch.memory == memory && address <= watch.last && last >= watch.first &&
+                std::find(m_hits.begin(), m_hits.end(), watch.id) == m_hits.end())
+                m_hits.push_back(watch.id);
+        }
+    }
+
+    std::vector<Condition> m_conditions;
+    std::vector<Watch> m_watches;
+    std::vector<Observer> m_observers;
+    std::vector<Id> m_hits;
+    Id m_nextId = 0;
+    bool m_inCycle = false;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_BREAKPOINTS_H
@@ -28,6 +28,25 @@ public:
             return value;
         };
     }
+
+    std::string nativeExpression(const PortBase*, const NativeOperand& operand) const override {
+        if (W > 32)
+            return {};  // Bits are shifted as int; defer to the propagation function
+        std::string expr = "(";
+        for (unsigned i = 0; i < W; i++)
+            expr += (i == 0 ? "" : " | ") + ("((" + operand(in[i]) + " & 1u) << " + std::to_string(i) + ")");
+        return expr + ")";
+    }
+
+    BatchPrimitive batchPrimitive(const PortBase*) const override {
+        if (W > 32)
+            return {};
+        BatchPrimitive p;
+        p.op = BatchPrimitive::Op::collate;
+        p.operands.assign(in.begin(), in.end());
+        return p;
+    }
+
     OUTPUTPORT(out, W);
     INPUTPORTS(in, 1, W);
 };
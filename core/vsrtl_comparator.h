@@ -6,23 +6,29 @@
 namespace vsrtl {
 namespace core {
 
-#define CMP_COMPONENT(classname, valFunc, op)                                         \
-    template <unsigned int W>                                                         \
-    class classname : public Component {                                              \
-    public:                                                                           \
-        classname(const std::string& name, SimComponent* parent) : Component(name, parent) { \
-            out << [=] { return op1.valFunc() op op2.valFunc(); };                    \
-        }                                                                             \
-        OUTPUTPORT(out, 1);                                                           \
-        INPUTPORT(op1, W);                                                            \
-        INPUTPORT(op2, W);                                                            \
+#define CMP_COMPONENT(classname, valFunc, op, isSigned)                                                     \
+    template <unsigned int W>                                                                               \
+    class classname : public Component {                                                                    \
+    public:                                                                                                 \
+        classname(const std::string& name, SimComponent* parent) : Component(name, parent) {                \
+            out << [=] { return op1.valFunc() op op2.valFunc(); };                                          \
+        }                                                                                                   \
+        std::string nativeExpression(const PortBase*, const NativeOperand& operand) const override {        \
+            auto value = [&](const PortBase* p) {                                                           \
+                return isSigned ? "vsrtl_sext(" + operand(p) + ", " + std::to_string(W) + ")" : operand(p); \
+            };                                                                                              \
+            return "static_cast<uint64_t>(" + value(&op1) + " " #op " " + value(&op2) + ")";                \
+        }                                                                                                   \
+        OUTPUTPORT(out, 1);                                                                                 \
+        INPUTPORT(op1, W);                                                                                  \
+        INPUTPORT(op2, W);                                                                                  \
     };
 
-CMP_COMPONENT(Sge, sValue, >=)
-CMP_COMPONENT(Slt, sValue, <)
-CMP_COMPONENT(Uge, uValue, >=)
-CMP_COMPONENT(Ult, uValue, <)
-CMP_COMPONENT(Eq, uValue, ==)
+CMP_COMPONENT(Sge, sValue, >=, true)
+CMP_COMPONENT(Slt, sValue, <, true)
+CMP_COMPONENT(Uge, uValue, >=, false)
+CMP_COMPONENT(Ult, uValue, <, false)
+CMP_COMPONENT(Eq, uValue, ==, false)
 
 }  // namespace core
 }  // namespace vsrtl
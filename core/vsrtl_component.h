@@ -64,6 +64,67 @@ public:
     bool isPropagated() const { return m_propagationState == PropagationState::propagated; }
     void setSensitiveTo(const PortBase* p) { m_sensitivityList.push_back(p); }
     void setSensitiveTo(const PortBase& p) { setSensitiveTo(&p); }
+    const std::vector<const PortBase*>& getSensitivityList() const { return m_sensitivityList; }
+
+    /**
+     * @brief forEachPort
+     * Calls @p f with each input port, output port and signal of this component. Unlike getAllPorts() and
+     * getSignals(), no intermediate containers are created.
+     */
+    template <typename F>
+    void forEachPort(F&& f) const {
+        for (const auto* ports : {&m_inputPorts, &m_outputPorts, &m_signals}) {
+            for (const auto& p : *ports)
+                f(static_cast<PortBase*>(p.get()));
+        }
+    }
+    size_t portCount() const { return m_inputPorts.size() + m_outputPorts.size() + m_signals.size(); }
+
+    /**
+     * @brief setStateful
+     * Marks the outputs of this component as depending on state which is not visible through its input ports or
+     * sensitivity list (ie. the contents of a memory). Stateful components are reevaluated in every cycle by
+     * activity-driven propagation.
+     */
+    void setStateful() { m_stateful = true; }
+    bool isStateful() const { return m_stateful; }
+
+    /// Maps a port to a C++ expression evaluating to the (unsigned) value of the port within generated native code.
+    using NativeOperand = std::function<std::string(const PortBase*)>;
+
+    /**
+     * @brief nativeExpression
+     * Returns a C++ expression which computes the value of output port @p port, used when compiling a design to native
+     * code (see NativeNetlist). The expression may use vsrtl_sext(value, width) to sign extend an operand. An empty
+     * expression signifies that the behavior of the port is opaque, in which case the generated code calls the
+     * propagation function of the port.
+     * @note Components which reassign the propagation function of a port of a base class must also reimplement this.
+     */
+    virtual std::string nativeExpression(const PortBase* /* port */, const NativeOperand& /* operand */) const {
+        return {};
+    }
+
+    /**
+     * @brief The BatchPrimitive struct
+     * Describes an output port as a primitive operation over a set of operand ports, such that the port may be
+     * evaluated across many simulation lanes at once (see BatchSimulator). Shift amounts are given as the immediate.
+     * The multiplexer operands are {select, ins...}, the ALU operands are {ctrl, op1, op2}. Collation assembles the
+     * least significant bit of each operand i into bit i of the output.
+     */
+    struct BatchPrimitive {
+        enum class Op { none, constant, bitAnd, bitOr, bitXor, bitNand, bitNot, add, shl, shr, sra, mux, alu, collate };
+        Op op = Op::none;
+        std::vector<const PortBase*> operands;
+        VSRTL_VT_U immediate = 0;
+    };
+
+    /**
+     * @brief batchPrimitive
+     * Returns the primitive operation computing output port @p port. Ports of components without a primitive
+     * description (Op::none) are evaluated lane by lane through their propagation function.
+     * @note Components which reassign the propagation function of a port of a base class must also reimplement this.
+     */
+    virtual BatchPrimitive batchPrimitive(const PortBase* /* port */) const { return {}; }
 
 
     bool isCompActivePath() const { return m_compActivePath; }
@@ -108,111 +169,219 @@ public:
         return createPorts<W>(name, m_outputPorts, vsrtl::SimPort::PortType::out, n);
     }
 
+    /**
+     * @brief propagateComponent
+     * Appends the ports of this component, and of all components which may subsequently be propagated, to
+     * @p propagationStack in the order in which they may be propagated.
+     * The algorithm is described recursively (see PropagationFrame), but is executed through an explicit stack of
+     * frames, such that the depth of the circuit is not bounded by the native stack.
+     */
     void propagateComponent(std::vector<PortBase*>& propagationStack) {
-        // Component has already been propagated
-        if (m_propagationState == PropagationState::propagated)
-            return;
+        // Frames above the current depth are retained, such that their callee lists are reused rather than reallocated
+        std::vector<PropagationFrame> frames(1);
+        frames[0].reset(this);
+        size_t depth = 1;
+        while (depth > 0) {
+            auto& frame = frames[depth - 1];
+            if (frame.next < frame.callees.size()) {
+                Component* callee = frame.callees[frame.next++];
+                if (depth == frames.size())
+                    frames.emplace_back();
+                frames[depth++].reset(callee);
+                continue;
+            }
+            if (!frame.component->propagationStep(frame, propagationStack))
+                depth--;
+        }
+    }
 
-        if (isSynchronous()) {
-            // Registers are implicitely clocked by calling propagate() on its output ports.
-            /** @remark register <must> be saved before propagateComponent reaches the register ! */
+    void initialize() {
+        if (m_inputPorts.size() == 0 && !hasSubcomponents() && m_sensitivityList.empty()) {
+            // Component has no input ports - ie. component is a constant. propagate all output ports and set component
+            // as propagated.
+            for (const auto& p : getPorts<SimPort::PortType::out, PortBase>())
+                p->propagateConstant();
             m_propagationState = PropagationState::propagated;
-            for (const auto& s : getPorts<SimPort::PortType::out, PortBase>()) {
-                s->propagate(propagationStack);
-            }
-        } else {
-            /* A circuit should initially ask its subcomponents to propagate. Some subcomponents may be able to
-             * propagate and some may not. Furthermore, This subcomponent (X) may be dependent on some of its internal
-             * subcomponents to propagate.
-             * Example:
-             * Port Y is propagated, and now asks X to propagate.
-             * X contains two subcomponents, B and A. A has all of its inputs (Y) propagated. B is reliant on 'z' to be
-             * propagated. However, 'z' is dependent on A being propagated.
-             *
-             * 1.
-             * X is trying to propagate, will initially ask its subcomponents to propagate.
-             *
-             * 1.
-             * Asking A to propagate, will make port (h) propagated.
-             * Asking B to propagate is invalid, because 'z' is unpropagated.
-             *
-             * 2.
-             * Component X will then check whether all of its input ports are propagated (z, i). 'i' is propagated, but
-             * 'z' is not, so the propagation algorithm will ask the parent component of port 'z' to propagate (C).
-             *
-             * 3.
-             * C has one input which attaches to port 'h' of A - which is now propagated. So C may propagate, in turn
-             * making 'z' propagated.
-             *
-             * 4.
-             * All inputs have now been propagated to X. It will then again ask its subcomponents to try to
-             * propagate.
-             *
-             * 5.
-             *
-             *  y
-             *  +                 X
-             *  |          +--------------+
-             *  |          |   +------+   |
-             *  |          |   |      |   |
-             *  |          |   |  B   |   |
-             *  |      z   |   |      |   |        +------+
-             *  |    +---->---->      |   |        |      |
-             *  |    |     |   +------+   |        |      |
-             *  |    |     |              |    +--->  C   +----+
-             *  |    |     |   +------+   |    |   |      |    |
-             *  |    |  i  |   |      | h |    |   +------+    |
-             *  +--------->---->  A   +--------+               |
-             *       |     |   |      |   |                    |
-             *       |     |   |      |   |                    |
-             *       |     |   +------+   |                    |
-             *       |     |              |                    |
-             *       |     +--------------+                    |
-             *       |                                         |
-             *       +-----------------------------------------+
-             *
-             */
-
-            for (const auto& sc : getSubComponents<Component>())
-                sc->propagateComponent(propagationStack);
-
-            // All sequential logic must have their inputs propagated before they themselves can propagate. If this is
-            // not the case, the function will return. Iff the circuit is correctly connected, this component will at a
-            // later point be visited, given that the input port which is currently not yet propagated, will become
-            // propagated at some point, signalling its connected components to propagate.
-            for (const auto& input : getPorts<SimPort::PortType::in, PortBase>()) {
-                if (!input->isPropagated())
-                    return;
-            }
-            // Furthermore, we check whether any additional signals added to the sensitivity list are propagated.
-            for (const auto& sens : m_sensitivityList) {
-                if (!sens->isPropagated())
-                    return;
-            }
+        }
+    }
 
-            for (const auto& sc : getSubComponents<Component>())
-                sc->propagateComponent(propagationStack);
+    /**
+     * @brief foldConstant
+     * A combinational component whose input ports and sensitivity list are all constant is itself constant. Its output
+     * ports are propagated as constants, and the component is thus never scheduled for propagation. Synchronous,
+     * stateful, hierarchical and parameterized components are never folded, given that their outputs may depend on more
+     * than their inputs.
+     * @returns whether the component was folded.
+     */
+    bool foldConstant() {
+        if (m_propagationState == PropagationState::propagated || isSynchronous() || isStateful() ||
+            hasSubcomponents() || !m_parameters.empty() || (m_inputPorts.empty() && m_sensitivityList.empty()))
+            return false;
+        for (const auto& input : getPorts<SimPort::PortType::in, PortBase>()) {
+            if (!input->isConstant())
+                return false;
+        }
+        for (const auto& sens : m_sensitivityList) {
+            if (!sens->isConstant())
+                return false;
+        }
+        for (const auto& p : getPorts<SimPort::PortType::out, PortBase>())
+            p->propagateConstant();
+        m_propagationState = PropagationState::propagated;
+        return true;
+    }
 
-            // At this point, all input ports are assured to be propagated. In this case, it is safe to propagate
-            // the outputs of the component.
-            for (const auto& s : getPorts<SimPort::PortType::out, PortBase>()) {
-                s->propagate(propagationStack);
+    virtual void verifyComponent() const {
+        for (const auto& ip : getPorts<SimPort::PortType::in, PortBase>()) {
+            if (!ip->isConnected()) {
+                throw std::runtime_error("Component: '" + getName() + "' has unconnected input '" + ip->getName());
             }
-            m_propagationState = PropagationState::propagated;
-
-            // if any internal values have changed...
-            // @todo: implement granular change signal emission
-            if (getDesign()->signalsEnabled()) {
-                changed.Emit();
+        }
+        for (const auto& op : getPorts<SimPort::PortType::out, PortBase>()) {
+            if (!op->isConnected()) {
+                throw std::runtime_error("Component: '" + getName() + "' has unconnected output '" + op->getName());
             }
         }
+    }
+
+protected:
+    /* A circuit should initially ask its subcomponents to propagate. Some subcomponents may be able to
+         * propagate and some may not. Furthermore, This subcomponent (X) may be dependent on some of its internal
+         * subcomponents to propagate.
+         * Example:
+         * Port Y is propagated, and now asks X to propagate.
+         * X contains two subcomponents, B and A. A has all of its inputs (Y) propagated. B is reliant on 'z' to be
+         * propagated. However, 'z' is dependent on A being propagated.
+         *
+         * 1.
+         * X is trying to propagate, will initially ask its subcomponents to propagate.
+         *
+         * 1.
+         * Asking A to propagate, will make port (h) propagated.
+         * Asking B to propagate is invalid, because 'z' is unpropagated.
+         *
+         * 2.
+         * Component X will then check whether all of its input ports are propagated (z, i). 'i' is propagated, but
+         * 'z' is not, so the propagation algorithm will ask the parent component of port 'z' to propagate (C).
+         *
+         * 3.
+         * C has one input which attaches to port 'h' of A - which is now propagated. So C may propagate, in turn
+         * making 'z' propagated.
+         *
+         * 4.
+         * All inputs have now been propagated to X. It will then again ask its subcomponents to try to
+         * propagate.
+         *
+         * 5.
+         *
+         *  y
+         *  +                 X
+         *  |          +--------------+
+         *  |          |   +------+   |
+         *  |          |   |      |   |
+         *  |          |   |  B   |   |
+         *  |      z   |   |      |   |        +------+
+         *  |    +---->---->      |   |        |      |
+         *  |    |     |   +------+   |        |      |
+         *  |    |     |              |    +--->  C   +----+
+         *  |    |     |   +------+   |    |   |      |    |
+         *  |    |  i  |   |      | h |    |   +------+    |
+         *  +--------->---->  A   +--------+               |
+         *       |     |   |      |   |                    |
+         *       |     |   |      |   |                    |
+         *       |     |   +------+   |                    |
+         *       |     |              |                    |
+         *       |     +--------------+                    |
+         *       |                                         |
+         *       +-----------------------------------------+
+         *
+         */
+    struct PropagationFrame {
+        Component* component = nullptr;
+        enum class Phase { enter, subcomponentsPreInputs, subcomponentsPostInputs, readers } phase = Phase::enter;
+        /// Components to propagate prior to the next step of this frame.
+        std::vector<Component*> callees = {};
+        size_t next = 0;
+
+        void reset(Component* c) {
+            component = c;
+            phase = Phase::enter;
+            callees.clear();
+            next = 0;
+        }
+    };
+
+    /**
+     * @brief propagationStep
+     * Executes the step of @p frame following the propagation of its callees, and determines the callees of the next
+     * step.
+     * @returns false if propagation of the component of @p frame has completed.
+     */
+    bool propagationStep(PropagationFrame& frame, std::vector<PortBase*>& propagationStack) {
+        using Phase = PropagationFrame::Phase;
+        frame.callees.clear();
+        frame.next = 0;
+        switch (frame.phase) {
+            case Phase::enter:
+                // Component has already been propagated
+                if (m_propagationState == PropagationState::propagated)
+                    return false;
+                if (isSynchronous()) {
+                    // Registers are implicitely clocked by calling propagate() on its output ports.
+                    /** @remark register <must> be saved before propagateComponent reaches the register ! */
+                    m_propagationState = PropagationState::propagated;
+                    propagateOutputs(propagationStack);
+                    return readersStep(frame);
+                }
+                frame.phase = Phase::subcomponentsPreInputs;
+                appendSubcomponents(frame.callees);
+                return true;
+
+            case Phase::subcomponentsPreInputs:
+                // All sequential logic must have their inputs propagated before they themselves can propagate. If this
+                // is not the case, propagation returns. Iff the circuit is correctly connected, this component will at
+                // a later point be visited, given that the input port which is currently not yet propagated, will
+                // become propagated at some point, signalling its connected components to propagate.
+                for (const auto& input : m_inputPorts) {
+                    if (!static_cast<PortBase*>(input.get())->isPropagated())
+                        return false;
+                }
+                // Furthermore, we check whether any additional signals added to the sensitivity list are propagated.
+                for (const auto& sens : m_sensitivityList) {
+                    if (!sens->isPropagated())
+                        return false;
+                }
+                frame.phase = Phase::subcomponentsPostInputs;
+                appendSubcomponents(frame.callees);
+                return true;
+
+            case Phase::subcomponentsPostInputs:
+                // At this point, all input ports are assured to be propagated. In this case, it is safe to propagate
+                // the outputs of the component.
+                propagateOutputs(propagationStack);
+                m_propagationState = PropagationState::propagated;
+
+                // if any internal values have changed...
+                // @todo: implement granular change signal emission
+                if (getDesign()->signalsEnabled()) {
+                    changed.Emit();
+                }
+                return readersStep(frame);
+
+            case Phase::readers:
+                return false;
+        }
+        return false;
+    }
 
-        // Signal all connected components of the current component to propagate
-        for (const auto& out : getPorts<SimPort::PortType::out, PortBase>()) {
-            for (const auto& in : out->getOutputPorts()) {
+    /// Signal all connected components of the current component to propagate
+    bool readersStep(PropagationFrame& frame) {
+        frame.phase = PropagationFrame::Phase::readers;
+        for (const auto& out : m_outputPorts) {
+            for (const auto& in : static_cast<PortBase*>(out.get())->drivenPorts()) {
                 // With the input port of the connected component propagated, the parent component may be propagated.
                 // This will succeed if all input components to the parent component has been propagated.
-                in->getParent<Component>()->propagateComponent(propagationStack);
+                frame.callees.push_back(in->getParent<Component>());
 
                 // To facilitate output -> output connections, we need to trigger propagation in the output's parent
                 // aswell
@@ -226,61 +395,47 @@ public:
                  *  |____________|
                  *
                  */
-                for (const auto& inout : in->getOutputPorts())
-                    inout->getParent<Component>()->propagateComponent(propagationStack);
+                for (const auto& inout : static_cast<PortBase*>(in)->drivenPorts())
+                    frame.callees.push_back(inout->getParent<Component>());
             }
         }
+        return true;
     }
 
-    void initialize() {
-        if (m_inputPorts.size() == 0 && !hasSubcomponents() && m_sensitivityList.empty()) {
-            // Component has no input ports - ie. component is a constant. propagate all output ports and set component
-            // as propagated.
-            for (const auto& p : getPorts<SimPort::PortType::out, PortBase>())
-                p->propagateConstant();
-            m_propagationState = PropagationState::propagated;
-        }
+    void appendSubcomponents(std::vector<Component*>& components) const {
+        for (const auto& sc : m_subcomponents)
+            components.push_back(static_cast<Component*>(sc.get()));
     }
 
-    virtual void verifyComponent() const {
-        for (const auto& ip : getPorts<SimPort::PortType::in, PortBase>()) {
-            if (!ip->isConnected()) {
-                throw std::runtime_error("Component: '" + getName() + "' has unconnected input '" + ip->getName());
-            }
-        }
-        for (const auto& op : getPorts<SimPort::PortType::out, PortBase>()) {
-            if (!op->isConnected()) {
-                throw std::runtime_error("Component: '" + getName() + "' has unconnected output '" + op->getName());
-            }
-        }
+    void propagateOutputs(std::vector<PortBase*>& propagationStack) {
+        for (const auto& s : m_outputPorts)
+            static_cast<PortBase*>(s.get())->propagate(propagationStack);
     }
 
-protected:
     template <unsigned int W, typename E_t = void>
-    Port<W>& createPort(const std::string& name, std::set<std::unique_ptr<SimPort>, PortBaseCompT>& container,
+    Port<W>& createPort(const std::string& name, PortSet& container,
                         vsrtl::SimPort::PortType type) {
         verifyIsUniquePortName(name);
         Port<W>* port;
         if constexpr (std::is_void<E_t>::value) {
-            port = static_cast<Port<W>*>((*container.emplace(std::make_unique<Port<W>>(name, this, type)).first).get());
+            port = static_cast<Port<W>*>(container.insert(createObject<Port<W>>(name, this, type)));
         } else {
-            port = static_cast<Port<W>*>(
-                (*container.emplace(std::make_unique<EnumPort<W, E_t>>(name, this, type)).first).get());
+            port = static_cast<Port<W>*>(container.insert(createObject<EnumPort<W, E_t>>(name, this, type)));
         }
         return *port;
     }
 
     template <unsigned int W>
     std::vector<Port<W>*> createPorts(const std::string& name,
-                                      std::set<std::unique_ptr<SimPort>, PortBaseCompT>& container,
+                                      PortSet& container,
                                       vsrtl::SimPort::PortType type, unsigned int n) {
         std::vector<Port<W>*> ports;
+        ports.reserve(n);
         Port<W>* port;
         for (unsigned int i = 0; i < n; i++) {
             std::string i_name = name + "_" + std::to_string(i);
             verifyIsUniquePortName(i_name);
-            port = static_cast<Port<W>*>(
-                (*container.emplace(std::make_unique<Port<W>>(i_name.c_str(), this, type)).first).get());
+            port = static_cast<Port<W>*>(container.insert(createObject<Port<W>>(i_name.c_str(), this, type)));
             ports.push_back(port);
         }
         return ports;
@@ -292,6 +447,7 @@ protected:
 
     std::vector<const PortBase*> m_sensitivityList;
     PropagationState m_propagationState = PropagationState::unpropagated;
+    bool m_stateful = false;
 };
 
 }  // namespace core
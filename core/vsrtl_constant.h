@@ -35,6 +35,14 @@ public:
         out << ([=] { return m_value; });
     }
 
+    std::string nativeExpression(const PortBase*, const NativeOperand&) const override {
+        return "UINT64_C(" + std::to_string(m_value) + ")";
+    }
+
+    BatchPrimitive batchPrimitive(const PortBase*) const override {
+        return {BatchPrimitive::Op::constant, {}, m_value};
+    }
+
     OUTPUTPORT(out, W);
 
 private:
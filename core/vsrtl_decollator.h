@@ -24,6 +24,20 @@ public:
         }
     }
 
+    std::string nativeExpression(const PortBase* port, const NativeOperand& operand) const override {
+        const auto i = std::find(out.begin(), out.end(), port) - out.begin();
+        if (i >= static_cast<long>(VSRTL_VT_BITS))
+            return {};  // Shift exceeds the value type; defer to the propagation function
+        return "((" + operand(&in) + " >> " + std::to_string(i) + ") & 1u)";
+    }
+
+    BatchPrimitive batchPrimitive(const PortBase* port) const override {
+        const auto i = std::find(out.begin(), out.end(), port) - out.begin();
+        if (i >= static_cast<long>(VSRTL_VT_BITS))
+            return {};
+        return {BatchPrimitive::Op::shr, {&in}, static_cast<VSRTL_VT_U>(i)};
+    }
+
     OUTPUTPORTS(out, 1, W);
     INPUTPORT(in, W);
 };
@@ -2,13 +2,32 @@
 #define VSRTL_DESIGN_H
 
 #include "../interface/vsrtl_defines.h"
+#include "vsrtl_activitypropagator.h"
+#include "vsrtl_bitnetlist.h"
+#include "vsrtl_breakpoints.h"
 #include "vsrtl_component.h"
+#include "vsrtl_flatnetlist.h"
+#include "vsrtl_levelizedpropagator.h"
+#include "vsrtl_loopdetector.h"
 #include "vsrtl_memory.h"
+#include "vsrtl_nativenetlist.h"
+#include "vsrtl_portgraph.h"
+#include "vsrtl_profiler.h"
 #include "vsrtl_register.h"
+#include "vsrtl_registerbank.h"
+#include "vsrtl_schedulecache.h"
+#include "vsrtl_snapshot.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <iterator>
+#include <map>
 #include <memory>
 #include <set>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 
 namespace vsrtl {
@@ -19,11 +38,29 @@ namespace core {
 #define ADDRESSSPACE(name) AddressSpace* name = this->createMemory<AddressSpace>()
 #define ADDRESSSPACEMM(name) AddressSpaceMM* name = this->createMemory<AddressSpaceMM>()
 
+/**
+ * @brief The PropagationMode enum
+ * interpreted: The propagation stack is traversed, and each port is propagated through a call to setPortValue().
+ * flat:        The propagation stack is lowered to a FlatNetlist, which is executed over the value table of the design.
+ * activity:    When clocking the design, only ports within the fan-out cones of registers whose output changed are
+ *              reevaluated (see ActivityPropagator).
+ * levelized:   The flat netlist is partitioned into dependency levels, and wide levels are evaluated concurrently by a
+ *              pool of worker threads (see LevelizedPropagator).
+ * native:      The propagation stack is compiled to native code (see Design::compileNative()).
+ * bitpacked:   1-bit logic gates are evaluated 64 at a time on bit-packed words, and all other ports are executed as a
+ *              flat netlist (see BitNetlist).
+ */
+enum class PropagationMode { interpreted, flat, activity, levelized, native, bitpacked };
+
+class BatchSimulator;
+
 /**
  * @brief The Design class
  * superclass for all Design descriptions
  */
 class Design : public SimDesign {
+    friend class BatchSimulator;
+
 public:
     Design(const std::string& name) : SimDesign(name, nullptr) {}
 
@@ -37,14 +74,14 @@ public:
             throw std::runtime_error("Design was not verified and initialized before clocking.");
         }
 
-        // Save register values (to correctly clock register -> register connections)
-        for (const auto& reg : m_clockedComponents) {
-            reg->save();
+        // Clocking without reapplying values forced later in the recorded history diverges from that history
+        if (!m_forcedValues.empty() && m_forcedValues.back().cycle > m_cycleCount) {
+            truncateHistory();
         }
 
-        ClockedComponent::pushReversibleCycle();
-        m_cycleCount++;
-        propagateDesign();
+        beginChangeSet();
+        clockDesign();
+        endChangeSet();
         SimDesign::clock();
     }
 
@@ -53,18 +90,20 @@ public:
             if (!isVerifiedAndInitialized()) {
                 throw std::runtime_error("Design was not verified and initialized before reversing.");
             }
-            // Clock registers
-            for (const auto& reg : m_clockedComponents) {
-                reg->reverse();
-            }
-            ClockedComponent::popReversibleCycle();
-            m_cycleCount--;
+            beginChangeSet();
+            reverseDesign();
             propagateDesign();
+            syncBreakpoints();
+            endChangeSet();
             SimDesign::reverse();
         }
     }
 
-    void propagate() override { propagateDesign(); }
+    void propagate() override {
+        beginChangeSet();
+        propagateDesign();
+        endChangeSet();
+    }
 
     /**
      * @brief reset
@@ -72,6 +111,7 @@ public:
      * circuit in terms of not all component values being 0.
      */
     void reset() override {
+        beginChangeSet();
         // Reset all memories, clearing the sparse arrays and rewriting any initialization data
         for (const auto& memory : m_memories) {
             memory->reset();
@@ -82,8 +122,12 @@ public:
         for (const auto& reg : m_clockedComponents)
             reg->reset();
         propagateDesign();
+        endChangeSet();
+        m_reverseJournal.clear();
         ClockedComponent::resetReverseStackCount();
         m_cycleCount = 0;
+        clearHistory();
+        syncBreakpoints();
         SimDesign::reset();
     }
 
@@ -95,11 +139,280 @@ public:
      */
     void setReverseStackSize(unsigned size) {
         ClockedComponent::setReverseStackSize(size);
+        m_reverseJournal.setDepth(size);
         for (const auto& c : m_clockedComponents) {
             c->reverseStackSizeChanged();
         }
     }
 
+    /**
+     * @brief reverseJournal
+     * The record of state overwritten in the reversible cycles of the design (see ReverseJournal).
+     */
+    const ReverseJournal& reverseJournal() const { return m_reverseJournal; }
+
+    /**
+     * @brief breakpoints
+     * The breakpoints of the design, which are evaluated once per clocked cycle (see BreakpointEngine). Clocking
+     * continues regardless of any breakpoints being hit; run loops (ie. runCycles()) stop at the cycle in which a
+     * breakpoint is hit.
+     */
+    BreakpointEngine& breakpoints() { return m_breakpoints; }
+    bool breakpointHit() const override { return m_breakpoints.hit(); }
+
+#ifdef VSRTL_PROFILING
+    /**
+     * @brief profiler
+     * Evaluation counts and times of the components of the design, accumulated since elaboration or since the
+     * profiler was last cleared. Ports are profiled when propagated through setPortValue(); the lowered propagation
+     * modes (flat, levelized, native and bitpacked) bypass this while signals are disabled, and are not profiled.
+     * Registers committed through the register bank are profiled in bulk, as saves of the design itself.
+     */
+    Profiler& profiler() { return m_profiler; }
+#endif
+
+    /// Number of registers committed through the register bank of the design (see createRegisterBank()).
+    size_t bankedRegisterCount() const { return m_registerBank.size(); }
+
+    /**
+     * @brief snapshot
+     * Captures the state of the design (the cycle count, the state of all clocked components and the contents of all
+     * address spaces) in a compact binary blob, which may later be passed to restore(). Address spaces are encoded
+     * sparsely, as runs of consecutive written bytes.
+     */
+    std::vector<uint8_t> snapshot() const {
+        if (!isVerifiedAndInitialized()) {
+            throw std::runtime_error("Design was not verified and initialized before taking a snapshot.");
+        }
+
+        SnapshotWriter writer;
+        writer.writeVarint(s_snapshotMagic);
+        writer.writeVarint(m_cycleCount);
+
+        writer.writeVarint(m_clockedComponents.size());
+        std::vector<VSRTL_VT_U> state;
+        for (const auto& c : m_clockedComponents) {
+            state.clear();
+            c->saveState(state);
+            writer.writeVarint(state.size());
+            for (const auto& word : state)
+                writer.writeVarint(word);
+        }
+
+        writer.writeVarint(m_memories.size());
+        std::vector<uint8_t> run;
+        for (const auto& memory : m_memories) {
+            const auto contents = memory->contents();
+            // Runs of consecutive addresses are encoded as (distance from the end of the previous run, length, bytes)
+            size_t runs = 0;
+            for (size_t i = 0; i < contents.size(); i++)
+                runs += i == 0 || contents[i].first != contents[i - 1].first + 1;
+            writer.writeVarint(runs);
+            VSRTL_VT_U end = 0;
+            for (size_t i = 0; i < contents.size();) {
+                const VSRTL_VT_U start = contents[i].first;
+                run.clear();
+                do {
+                    run.push_back(contents[i].second);
+                    i++;
+                } while (i < contents.size() && contents[i].first == contents[i - 1].first + 1);
+                writer.writeVarint(start - end);
+                writer.writeVarint(run.size());
+                writer.writeBytes(run.data(), run.size());
+                end = start + run.size();
+            }
+        }
+        return writer.take();
+    }
+
+    /**
+     * @brief restore
+     * Restores the design to the state captured in @p snapshot by snapshot(), in time proportional to the size of the
+     * state. The reverse journal is cleared; cycles prior to the restored state cannot be reversed.
+     * @throws std::runtime_error if the snapshot is malformed or was not taken from a design of equal structure. The
+     * design is left unmodified in that case.
+     */
+    void restore(const std::vector<uint8_t>& snapshot) {
+        if (!isVerifiedAndInitialized()) {
+            throw std::runtime_error("Design was not verified and initialized before restoring a snapshot.");
+        }
+
+        beginChangeSet();
+        restoreSnapshot(snapshot);
+        propagateDesign();
+        syncBreakpoints();
+        endChangeSet();
+        clearHistory();
+        SimDesign::restored();
+    }
+
+    /**
+     * @brief setCheckpointInterval
+     * Enables seek() to any cycle since the last reset by taking a checkpoint (see snapshot()) every @p interval
+     * cycles, and by recording the values forced through setSynchronousValue(). Smaller intervals make seeking faster
+     * at the cost of memory. An interval of 0 (the default) disables checkpointing and discards all checkpoints.
+     */
+    void setCheckpointInterval(unsigned interval) {
+        m_checkpointInterval = interval;
+        clearHistory();
+    }
+    unsigned checkpointInterval() const { return m_checkpointInterval; }
+    size_t checkpointCount() const { return m_checkpoints.size(); }
+
+    /**
+     * @brief seek
+     * Brings the design to the state it held (or, for cycles not yet simulated, will hold) at @p cycle. Past cycles
+     * are reached by reversing, if within the reverse journal, or else by restoring the nearest checkpoint at or
+     * before @p cycle and deterministically replaying the recorded history from there, such that the time taken is
+     * bounded by the checkpoint interval. Values forced at a cycle are reapplied when replaying it. Other external
+     * modifications of the design (ie. writes to its address spaces) are not recorded, and are not replayed.
+     * @throws std::runtime_error if @p cycle precedes both the reverse journal and the first checkpoint.
+     */
+    void seek(long long cycle) {
+        if (!isVerifiedAndInitialized()) {
+            throw std::runtime_error("Design was not verified and initialized before seeking.");
+        }
+        if (cycle < 0) {
+            throw std::runtime_error("Cannot seek to a negative cycle");
+        }
+        if (cycle == m_cycleCount)
+            return;
+
+        // Nearest checkpoint at or before the target cycle, if any
+        auto checkpoint = m_checkpoints.upper_bound(cycle);
+        const bool hasCheckpoint = checkpoint != m_checkpoints.begin();
+        if (hasCheckpoint)
+            checkpoint = std::prev(checkpoint);
+        const long long distance = m_cycleCount - cycle;
+        const bool canReverseTo = distance > 0 && static_cast<size_t>(distance) <= m_reverseJournal.cycleCount();
+        const bool useCheckpoint =
+            hasCheckpoint && (distance > 0 ? !canReverseTo || cycle - checkpoint->first < distance
+                                           : checkpoint->first > m_cycleCount);
+        if (distance > 0 && !canReverseTo && !useCheckpoint) {
+            throw std::runtime_error("Cycle " + std::to_string(cycle) +
+                                     " precedes the reversible and checkpointed history of the design");
+        }
+
+        // Intermediate cycles are simulated silently; afterwards, the ports which changed are signalled once.
+        const bool emitSignals = signalsEnabled();
+        const std::vector<VSRTL_VT_U> preSeekValues = emitSignals ? m_portValues : std::vector<VSRTL_VT_U>();
+        setEnableSignals(false);
+        beginChangeSet();
+        if (useCheckpoint) {
+            restoreSnapshot(checkpoint->second);
+            propagateDesign();
+            replayForcedValues();
+        }
+        if (m_cycleCount > cycle) {
+            while (m_cycleCount > cycle)
+                reverseDesign();
+            propagateDesign();
+        }
+        while (m_cycleCount < cycle) {
+            clockDesign();
+            replayForcedValues();
+        }
+        endChangeSet();
+        setEnableSignals(emitSignals);
+        syncBreakpoints();
+        if (emitSignals)
+            emitChangedSince(preSeekValues);
+        SimDesign::restored();
+    }
+
+    /**
+     * @brief The RunResult struct
+     * Outcome of runCycles().
+     */
+    struct RunResult {
+        /// Number of cycles which were clocked.
+        long long cycles = 0;
+        /// Whether the run was ended by its stop condition or a breakpoint, rather than by reaching the cycle limit.
+        bool stopped = false;
+        /// Wall-clock duration of the run.
+        std::chrono::nanoseconds elapsed{0};
+
+        double cyclesPerSecond() const {
+            return elapsed.count() == 0 ? 0.0 : cycles / std::chrono::duration<double>(elapsed).count();
+        }
+    };
+
+    /**
+     * @brief runCycles
+     * Clocks the design for up to @p n cycles, or until @p stop (a callable returning bool, evaluated after each cycle)
+     * holds or a breakpoint is hit. The cycles are run silently: no per-port or clocked signals are emitted, and
+     * changes are collected into a single change set. Afterwards, observers are brought up to date as if by a single
+     * call to clock(); the ports which changed are signalled once. When dumping to a VCD file, the changes of every
+     * cycle are still recorded. The cycles remain reversible, as when clocked individually.
+     */
+    template <typename P>
+    RunResult runCycles(long long n, const P& stop) {
+        if (!isVerifiedAndInitialized()) {
+            throw std::runtime_error("Design was not verified and initialized before running.");
+        }
+        RunResult result;
+        if (n <= 0)
+            return result;
+
+        if (!m_forcedValues.empty() && m_forcedValues.back().cycle > m_cycleCount) {
+            truncateHistory();
+        }
+
+        const bool perCycleChanges = vcdDump();
+        const bool emitSignals = signalsEnabled();
+        const bool emitClockedSignals = clockedSignalsEnabled();
+        const std::vector<VSRTL_VT_U> preRunValues = emitSignals ? m_portValues : std::vector<VSRTL_VT_U>();
+        setEnableSignals(false);
+        setEnableClockedSignals(false);
+        if (!perCycleChanges)
+            beginChangeSet();
+        const auto start = std::chrono::steady_clock::now();
+        while (result.cycles < n) {
+            if (perCycleChanges) {
+                beginChangeSet();
+                clockDesign();
+                endChangeSet();
+                SimDesign::clock();
+            } else {
+                clockDesign();
+            }
+            result.cycles++;
+            if (stop() || m_breakpoints.hit()) {
+                result.stopped = true;
+                break;
+            }
+        }
+        result.elapsed = std::chrono::steady_clock::now() - start;
+        setEnableSignals(emitSignals);
+        setEnableClockedSignals(emitClockedSignals);
+        if (emitSignals)
+            emitChangedSince(preRunValues);
+        if (!perCycleChanges) {
+            endChangeSet();
+            SimDesign::clock();
+        } else if (emitClockedSignals) {
+            designWasClocked.Emit();
+        }
+        return result;
+    }
+
+    /**
+     * Runs until @p port assumes @p value, for up to @p n cycles. If @p port was eliminated as unobserved (see
+     * setEliminateUnobservedPorts()), all unobserved ports are propagated during the run.
+     */
+    RunResult runCycles(long long n, const PortBase& port, VSRTL_VT_U value) {
+        const bool unobserved = std::any_of(m_unobservedPorts.begin(), m_unobservedPorts.end(),
+                                            [&port](const PortBase* p) { return p->valueSlot() == port.valueSlot(); });
+        m_propagateUnobserved = unobserved;
+        const auto result = runCycles(n, [&port, value] { return port.uValue() == value; });
+        m_propagateUnobserved = false;
+        return result;
+    }
+
+    RunResult runCycles(long long n) {
+        return runCycles(n, [] { return false; });
+    }
+
     void createPropagationStack() {
         // The circuit is traversed to find the sequence of which ports may be propagated, such that all input
         // dependencies for each component are met when a port is propagated. With this, propagateDesign() may
@@ -108,15 +421,251 @@ public:
             reg->propagateComponent(m_propagationStack);
     }
 
-    void propagateDesign() {
-        for (const auto& p : m_propagationStack)
+    /**
+     * @brief collapsePassThroughPorts
+     * Removes ports which merely forward the value of their input port (ie. ports connecting levels of the hierarchy)
+     * from the propagation stack. Each such port is aliased to the first port of its forwarding chain which is
+     * propagated, once the value table has been created. Ports are only aliased to ports of equal notify policy, such
+     * that the changed signal of an aliased port is emitted exactly as if it had been propagated.
+     */
+    void collapsePassThroughPorts() {
+        std::unordered_map<PortBase*, PortBase*> roots;
+        for (auto* ports : {&m_propagationStack, &m_unobservedPorts}) {
+            std::vector<PortBase*> kept;
+            kept.reserve(ports->size());
+            for (const auto& p : *ports) {
+                auto* in = p->getInputPort<PortBase>();
+                if (!p->hasPropagationFunction() && in != nullptr) {
+                    auto it = roots.find(in);
+                    auto* root = it != roots.end() ? it->second : in;
+                    if (root->notifyPolicy() == p->notifyPolicy()) {
+                        roots[p] = root;
+                        m_passThroughPorts.push_back({p, root});
+                        continue;
+                    }
+                }
+                kept.push_back(p);
+            }
+            *ports = std::move(kept);
+        }
+    }
+
+    /**
+     * @brief foldConstants
+     * Folds combinational components whose inputs are all constant (see Component::foldConstant()). Folding is
+     * repeated until no further components fold, such that constant cones are evaluated once during elaboration.
+     */
+    void foldConstants() {
+        bool folded = true;
+        while (folded) {
+            folded = false;
+            for (const auto& comp : m_components) {
+                if (comp->foldConstant()) {
+                    m_foldedComponentCount++;
+                    folded = true;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief eliminateUnobservedPorts
+     * Partitions the propagation stack into the ports which are observed (see setEliminateUnobservedPorts()), and the
+     * ports which are not. Both partitions retain propagation order; since no observed port depends on an unobserved
+     * port, propagating the unobserved ports after the observed ports is equivalent to the original order.
+     */
+    void eliminateUnobservedPorts() {
+        std::set<const PortBase*> observed;
+        for (auto it = m_propagationStack.rbegin(); it != m_propagationStack.rend(); ++it) {
+            PortBase* p = *it;
+            auto* parent = p->getParent<Component>();
+            const bool isRoot =
+                !parent || parent->isSynchronous() || parent->isStateful() || m_probes.count(p) != 0;
+            if (!isRoot && observed.count(p) == 0)
+                continue;
+
+            observed.insert(p);
+            if (!p->hasPropagationFunction()) {
+                observed.insert(p->getInputPort<PortBase>());
+            } else if (parent) {
+                for (const auto& in : parent->getInputPorts<PortBase>())
+                    observed.insert(in);
+                for (const auto& sens : parent->getSensitivityList())
+                    observed.insert(sens);
+            }
+        }
+
+        std::vector<PortBase*> stack;
+        for (const auto& p : m_propagationStack) {
+            if (observed.count(p) != 0)
+                stack.push_back(p);
+            else
+                m_unobservedPorts.push_back(p);
+        }
+        m_propagationStack = std::move(stack);
+    }
+
+    /**
+     * @brief propagateUnobserved
+     * Propagates the ports removed from the propagation stack by eliminateUnobservedPorts(), if they may be observed.
+     */
+    void propagateUnobserved() {
+        if (m_unobservedPorts.empty() ||
+            !(signalsEnabled() || recordsChanges() || m_propagateUnobserved || m_breakpoints.hasPortConditions()))
+            return;
+        for (const auto& p : m_unobservedPorts)
             p->setPortValue();
     }
 
+    /**
+     * @brief passThroughPortCount
+     * @returns the number of ports which were removed from the propagation stack by collapsePassThroughPorts().
+     */
+    size_t passThroughPortCount() const { return m_passThroughPorts.size(); }
+    size_t propagationStackSize() const { return m_propagationStack.size(); }
+
+    void propagateDesign() {
+        const bool lowered = !signalsEnabled();
+        if (lowered && m_propagationMode == PropagationMode::flat) {
+            m_flatNetlist.execute();
+        } else if (lowered && m_propagationMode == PropagationMode::levelized) {
+            m_levelizedPropagator.propagate();
+        } else if (lowered && m_propagationMode == PropagationMode::native) {
+            m_nativeNetlist.execute();
+        } else if (lowered && m_propagationMode == PropagationMode::bitpacked) {
+            m_bitNetlist.execute();
+        } else {
+            for (const auto& p : m_propagationStack)
+                p->setPortValue();
+        }
+        propagateUnobserved();
+    }
+
+    /**
+     * @brief setEliminateUnobservedPorts
+     * If enabled, ports which neither contribute to the state of the design (the inputs of synchronous and stateful
+     * components) nor to any probe (see addProbe()) are moved out of the propagation stack during
+     * verifyAndInitialize(). Unobserved ports are only propagated while they may be observed; when signals are enabled,
+     * when change sets are recorded (which includes VCD dumping), while breakpoint conditions on ports are set, or
+     * while runCycles() runs until an unobserved port assumes a value. Otherwise, their values are left stale; a stop
+     * condition of runCycles() given as a callable should thus not read unobserved ports.
+     */
+    void setEliminateUnobservedPorts(bool enabled) { m_eliminateUnobserved = enabled; }
+    bool eliminatesUnobservedPorts() const { return m_eliminateUnobserved; }
+
+    /**
+     * @brief setRelocatePortData
+     * If enabled, the propagation functions of all scheduled ports are moved into a contiguous array in propagation
+     * order once the value table has been created, such that the flat netlist and the propagation modes lowered from
+     * it walk both the values and the functions of the design sequentially, rather than visiting port objects
+     * scattered throughout the design. Must be set prior to verifyAndInitialize().
+     */
+    void setRelocatePortData(bool enabled) { m_relocatePortData = enabled; }
+    bool relocatesPortData() const { return m_relocatePortData; }
+
+    /**
+     * @brief addProbe
+     * Marks @p port as observed, such that it (and the logic driving it) is always propagated. Must be called prior to
+     * verifyAndInitialize().
+     */
+    void addProbe(const PortBase* port) { m_probes.insert(port); }
+
+    /**
+     * @brief foldedComponentCount
+     * @returns the number of components which were folded into constants by foldConstants().
+     */
+    size_t foldedComponentCount() const { return m_foldedComponentCount; }
+
+    /**
+     * @brief unobservedPortCount
+     * @returns the number of ports which were removed from the propagation stack by eliminateUnobservedPorts().
+     */
+    size_t unobservedPortCount() const { return m_unobservedPorts.size(); }
+
+    /**
+     * @brief setPropagationMode
+     * Selects the algorithm used by propagateDesign(). The mode may be changed at any point in time; structures which
+     * are specific to a mode (the port graph, levels and bit netlist) are built once the mode is first selected on an
+     * initialized design (see preparePropagationMode()).
+     * Activity-driven propagation is only applied when clocking the design; any other change to the state of the
+     * design (reset, reverse, forced register values) results in a full propagation.
+     * @note The flat netlist does not emit per-port change signals. It is therefore only used when signal emission is
+     * disabled (ie. when running the design continuously or headless). With signals enabled, ports are propagated
+     * individually.
+     */
+    void setPropagationMode(PropagationMode mode) {
+        if (mode == PropagationMode::native && !m_nativeNetlist.isCompiled()) {
+            throw std::runtime_error("Design must be compiled through compileNative() prior to native propagation");
+        }
+        m_propagationMode = mode;
+        if (isVerifiedAndInitialized())
+            preparePropagationMode();
+    }
+    PropagationMode propagationMode() const { return m_propagationMode; }
+
+    /**
+     * @brief compileNative
+     * Generates C++ code for the propagation stack of the design, and builds and loads it using @p compiler (see
+     * NativeNetlist::compile()). Once compiled, native propagation may be selected through setPropagationMode().
+     * @throws std::runtime_error if the design could not be compiled.
+     */
+    void compileNative(const std::string& compiler = {}) {
+        if (!isVerifiedAndInitialized()) {
+            throw std::runtime_error("Design was not verified and initialized before compiling.");
+        }
+        m_nativeNetlist.generate(m_propagationStack, m_portValues.data());
+        m_nativeNetlist.compile(compiler);
+    }
+    const NativeNetlist& nativeNetlist() const { return m_nativeNetlist; }
+    const BitNetlist& bitNetlist() {
+        if (isVerifiedAndInitialized() && !m_bitNetlist.isLowered())
+            m_bitNetlist.lower(m_propagationStack, m_portValues.data(), propagationDependencies());
+        return m_bitNetlist;
+    }
+
+    /**
+     * @brief setPropagationThreads
+     * Sets the number of threads (including the calling thread) used by levelized propagation. Defaults to the number
+     * of hardware threads.
+     */
+    void setPropagationThreads(unsigned threads) { m_levelizedPropagator.setThreadCount(threads); }
+    unsigned propagationThreads() const { return m_levelizedPropagator.threadCount(); }
+
+    /**
+     * @brief setParallelThreshold
+     * Levels of the design narrower than @p width ports are not distributed across threads during levelized
+     * propagation.
+     */
+    void setParallelThreshold(unsigned width) { m_levelizedPropagator.setParallelThreshold(width); }
+    unsigned parallelThreshold() const { return m_levelizedPropagator.parallelThreshold(); }
+
+    /**
+     * @brief addNotifyRule
+     * Ports whose hierarchical name contains @p pattern are assigned the notification @p policy when the design is
+     * verified and initialized. Rules are applied in order of addition, and so later rules take precedence.
+     * By default, all ports of designs containing "MIPS" in their hierarchical name always notify, given that the
+     * graphical views of such designs track active paths independently of port values.
+     */
+    void addNotifyRule(const std::string& pattern, PortBase::NotifyPolicy policy) {
+        m_notifyRules.push_back({pattern, policy});
+    }
+    void clearNotifyRules() { m_notifyRules.clear(); }
+
     void setSynchronousValue(SimSynchronous* c, VSRTL_VT_U addr, VSRTL_VT_U value) override {
+        if (m_checkpointInterval != 0) {
+            // Forcing a value diverges from any history recorded after the current cycle
+            truncateHistory();
+            auto it = std::find(m_clockedComponents.begin(), m_clockedComponents.end(), c);
+            if (it != m_clockedComponents.end()) {
+                m_forcedValues.push_back({m_cycleCount, static_cast<uint32_t>(it - m_clockedComponents.begin()), addr,
+                                          value});
+            }
+        }
+        beginChangeSet();
         c->forceValue(addr, value);
         // Given the new output value of the register, the circuit must be repropagated
         propagateDesign();
+        endChangeSet();
     }
 
     /**
@@ -128,72 +677,144 @@ public:
         if (isVerifiedAndInitialized())
             return;
 
+        m_elaborationTimes.clear();
+        auto stageCompleted = [this, start = std::chrono::steady_clock::now()](const char* stage) mutable {
+            const auto now = std::chrono::steady_clock::now();
+            m_elaborationTimes.push_back({stage, std::chrono::duration_cast<std::chrono::nanoseconds>(now - start)});
+            start = now;
+        };
+
         createComponentGraph();
+        stageCompleted("component graph");
 
-        for (const auto& c : m_componentGraph) {
-            auto* comp = c.first->cast<Component>();
-            if (!comp) {
-                if (c.first->cast<Design>())
-                    continue;
-                else
-                    assert(false && "Trying to verify unknown component");
-            }
+        for (const auto& comp : m_components) {
             // Verify that all components has no undefined input signals
             comp->verifyComponent();
             // Initialize the component
             comp->initialize();
         }
+        stageCompleted("verification");
 
-        if (detectCombinationalLoop()) {
-            throw std::runtime_error("Combinational loop detected in circuit");
+        // A schedule cached by a previous elaboration of the same design replaces loop detection and the creation of
+        // the propagation stack
+        std::unique_ptr<ScheduleCache> scheduleCache;
+        std::string schedulePath;
+        uint64_t designHash = 0;
+        m_scheduleRestored = false;
+        if (!m_scheduleCacheDirectory.empty()) {
+            scheduleCache = std::make_unique<ScheduleCache>(m_components);
+            designHash = scheduleHash(*scheduleCache);
+            char fileName[32];
+            std::snprintf(fileName, sizeof(fileName), "%016" PRIx64 ".vsched", designHash);
+            schedulePath = m_scheduleCacheDirectory + "/" + fileName;
+            m_scheduleRestored = restoreSchedule(*scheduleCache, schedulePath, designHash);
+            stageCompleted("schedule cache");
         }
 
-        // Traverse the graph to create the optimal propagation sequence
-        createPropagationStack();
+        if (!m_scheduleRestored) {
+            collectClockedComponents();
+            const auto loops = combinationalLoops();
+            if (!loops.empty()) {
+                std::string message = "Combinational loop detected in circuit:";
+                for (const auto& loop : loops) {
+                    message += "\n ";
+                    for (const auto& name : loop)
+                        message += " " + name;
+                }
+                throw std::runtime_error(message);
+            }
+            stageCompleted("loop detection");
+        }
+
+        foldConstants();
+        resolveNotifyPolicies();
+        stageCompleted("constant folding");
+
+        if (!m_scheduleRestored) {
+            // Traverse the graph to create the optimal propagation sequence
+            createPropagationStack();
+            if (m_eliminateUnobserved)
+                eliminateUnobservedPorts();
+            collapsePassThroughPorts();
+            if (scheduleCache)
+                storeSchedule(*scheduleCache, schedulePath, designHash);
+            stageCompleted("propagation stack");
+        }
+
+        m_reverseJournal.setDepth(ClockedComponent::reverseStackSize());
+        for (uint32_t i = 0; i < m_clockedComponents.size(); i++)
+            m_clockedComponents[i]->attachJournal(&m_reverseJournal, i);
+
+        // Move all port values into the contiguous value table, and lower the propagation stack to operate on it
+        createValueTable();
+        m_breakpoints.resolve();
+        createRegisterBank();
+        if (m_relocatePortData)
+            relocatePortFunctions();
+        m_flatNetlist.lower(m_propagationStack, m_portValues.data());
+        stageCompleted("value table");
+        preparePropagationMode();
+        stageCompleted("propagation mode");
+#ifdef VSRTL_PROFILING
+        attachProfiler();
+#endif
 
         // Reset the circuit to propagate initial state
         // @todo this should be changed, such that ports initially have a value of "X" until they are assigned
         reset();
+        stageCompleted("reset");
 
         SimDesign::verifyAndInitialize();
+        // The initial state is the first checkpoint, if checkpointing is enabled
+        clearHistory();
+#ifdef VSRTL_PROFILING
+        m_profiler.clear();
+#endif
     }
 
-    bool cycleUtil(SimComponent* c, std::map<SimComponent*, bool>& visited,
-                   std::map<SimComponent*, bool>& recurseStack) {
-        visited[c] = true;
-        recurseStack[c] = true;
-        if (!dynamic_cast<ClockedComponent*>(c))  // Graph is cut at registers
-            return false;
+    /**
+     * @brief setScheduleCacheDirectory
+     * Enables caching of the propagation schedule of the design within @p directory, which must exist. Elaborating a
+     * design whose schedule has been cached restores the propagation stack and clocked components from the cache,
+     * skipping loop detection and the creation of the propagation stack (see ScheduleCache). An empty @p directory
+     * disables the cache. Must be called prior to verifyAndInitialize().
+     */
+    void setScheduleCacheDirectory(const std::string& directory) { m_scheduleCacheDirectory = directory; }
+    const std::string& scheduleCacheDirectory() const { return m_scheduleCacheDirectory; }
 
-        for (const auto& neighbour : m_componentGraph[c]) {
-            if (!visited[neighbour] && cycleUtil(neighbour, visited, recurseStack)) {
-                return true;
-            } else if (recurseStack[neighbour]) {
-                return true;
-            }
-        }
+    /**
+     * @brief scheduleRestored
+     * @returns whether the schedule of the last call to verifyAndInitialize() was restored from the schedule cache.
+     */
+    bool scheduleRestored() const { return m_scheduleRestored; }
 
-        recurseStack[c] = false;
-        return false;
+    /**
+     * @brief elaborationTimes
+     * The time spent within each stage of the last call to verifyAndInitialize(), in order of execution.
+     */
+    const std::vector<std::pair<std::string, std::chrono::nanoseconds>>& elaborationTimes() const {
+        return m_elaborationTimes;
     }
 
-    bool detectCombinationalLoop() {
-        std::map<SimComponent*, bool> visited;
-        for (const auto& cptr : m_componentGraph) {
-            visited[cptr.first] = false;
-        }
-        std::map<SimComponent*, bool> recurseStack;
+    /**
+     * @brief combinationalLoops
+     * @returns the hierarchical names of the ports of each combinational loop within the design (see LoopDetector).
+     */
+    std::vector<std::vector<std::string>> combinationalLoops() {
+        if (m_components.empty())
+            createComponentGraph();
 
-        for (const auto& c : m_componentGraph) {
-            if (visited[c.first] == false) {
-                return cycleUtil(c.first, visited, recurseStack);
-            } else {
-                return false;
-            }
+        std::vector<std::vector<std::string>> loops;
+        for (const auto& loop : LoopDetector().findLoops(m_components)) {
+            loops.emplace_back();
+            for (const auto& p : loop)
+                loops.back().push_back(p->getHierName());
         }
-        return false;
+        return loops;
     }
 
+    bool detectCombinationalLoop() { return !combinationalLoops().empty(); }
+
     template <typename T>
     T* createMemory() {
         static_assert(std::is_base_of<AddressSpace, T>::value);
@@ -204,27 +825,613 @@ public:
     }
 
 private:
+    /**
+     * @brief restoreSnapshot
+     * Restores the state captured in @p snapshot, without propagating the circuit. See restore().
+     */
+    void restoreSnapshot(const std::vector<uint8_t>& snapshot) {
+        // The snapshot is fully decoded and validated before any state is modified
+        SnapshotReader reader(snapshot);
+        if (reader.readVarint() != s_snapshotMagic) {
+            throw std::runtime_error("Not a design snapshot");
+        }
+        const auto cycleCount = static_cast<long long>(reader.readVarint());
+
+        if (reader.readVarint() != m_clockedComponents.size()) {
+            throw std::runtime_error("Design snapshot does not match the design");
+        }
+        std::vector<VSRTL_VT_U> state;
+        for (const auto& c : m_clockedComponents) {
+            const auto n = reader.readVarint();
+            if (n != c->stateSize()) {
+                throw std::runtime_error("Design snapshot does not match the design");
+            }
+            for (uint64_t i = 0; i < n; i++)
+                state.push_back(reader.readVarint());
+        }
+
+        if (reader.readVarint() != m_memories.size()) {
+            throw std::runtime_error("Design snapshot does not match the design");
+        }
+        std::vector<std::vector<std::pair<VSRTL_VT_U, uint8_t>>> contents(m_memories.size());
+        for (auto& memory : contents) {
+            const auto runs = reader.readVarint();
+            VSRTL_VT_U end = 0;
+            for (uint64_t r = 0; r < runs; r++) {
+                const VSRTL_VT_U start = end + reader.readVarint();
+                const auto length = reader.readVarint();
+                const uint8_t* bytes = reader.readBytes(length);
+                for (uint64_t i = 0; i < length; i++)
+                    memory.push_back({start + i, bytes[i]});
+                end = start + length;
+            }
+        }
+        if (!reader.atEnd()) {
+            throw std::runtime_error("Malformed design snapshot");
+        }
+
+        for (size_t i = 0; i < m_memories.size(); i++)
+            m_memories[i]->setContents(contents[i]);
+        const VSRTL_VT_U* words = state.data();
+        for (const auto& c : m_clockedComponents) {
+            c->restoreState(words);
+            words += c->stateSize();
+        }
+        m_reverseJournal.clear();
+        ClockedComponent::resetReverseStackCount();
+        m_cycleCount = cycleCount;
+    }
+
+#ifdef VSRTL_PROFILING
+    /**
+     * @brief attachProfiler
+     * Points the ports, saved components and memory accessors of the design to their counters within the profiler.
+     */
+    void attachProfiler() {
+        for (auto* ports : {&m_propagationStack, &m_unobservedPorts}) {
+            for (const auto& p : *ports)
+                p->setProfileCounter(m_profiler.counter(p->getParent<SimComponent>(), Profiler::Event::evaluate));
+        }
+        m_saveProfiles.clear();
+        for (const auto& c : m_savedComponents)
+            m_saveProfiles.push_back(m_profiler.counter(c, Profiler::Event::save));
+        m_registerBankProfile = m_registerBank.size() == 0 ? nullptr : m_profiler.counter(this, Profiler::Event::save);
+        for (const auto& c : m_components) {
+            auto attach = [&](auto* memory) {
+                if (memory)
+                    memory->setProfileCounters(m_profiler.counter(c, Profiler::Event::memoryRead),
+                                               m_profiler.counter(c, Profiler::Event::memoryWrite));
+            };
+            attach(dynamic_cast<BaseMemory<true>*>(c));
+            attach(dynamic_cast<BaseMemory<false>*>(c));
+        }
+    }
+#endif
+
+    void syncBreakpoints() {
+        if (m_breakpoints.armed())
+            m_breakpoints.sync();
+    }
+
+    /**
+     * @brief emitChangedSince
+     * Emits the changed signal of each port whose value differs from that within the value table snapshot @p values.
+     */
+    void emitChangedSince(const std::vector<VSRTL_VT_U>& values) {
+        for (size_t i = 0; i < m_portValues.size(); i++) {
+            if ((m_portValues[i] ^ values[i]) & m_slotMasks[i]) {
+                m_slotPorts[i]->changed.Emit();
+                for (const auto& alias : m_slotPorts[i]->aliases())
+                    alias->changed.Emit();
+            }
+        }
+    }
+
+    /**
+     * @brief clockDesign
+     * Clocks the circuit and propagates it. Takes a checkpoint if one is due at the new cycle.
+     */
+    void clockDesign() {
+        // Save register values (to correctly clock register -> register connections). State overwritten by doing so is
+        // recorded to the journal of this cycle.
+        const bool breakpointsArmed = m_breakpoints.armed();
+        if (breakpointsArmed)
+            m_breakpoints.beginCycle();
+        m_reverseJournal.beginCycle();
+        {
+            VSRTL_PROFILE(m_registerBankProfile);
+            m_registerBank.commit(m_portValues.data(), m_reverseJournal);
+        }
+        for (size_t i = 0; i < m_savedComponents.size(); i++) {
+            VSRTL_PROFILE(m_saveProfiles[i]);
+            m_savedComponents[i]->save();
+        }
+
+        ClockedComponent::pushReversibleCycle();
+        m_cycleCount++;
+        if (m_propagationMode == PropagationMode::activity) {
+            // Banked registers are not seeds of activity propagation; only those which changed value are reevaluated
+            for (const auto& slot : m_registerBank.changedOutputs())
+                m_activityPropagator.markDirty(slot);
+            m_activityPropagator.propagate();
+            propagateUnobserved();
+        } else {
+            propagateDesign();
+        }
+
+        if (breakpointsArmed)
+            m_breakpoints.evaluate();
+
+        if (m_checkpointInterval != 0 && m_cycleCount % m_checkpointInterval == 0 &&
+            m_checkpoints.count(m_cycleCount) == 0) {
+            m_checkpoints.emplace(m_cycleCount, snapshot());
+        }
+    }
+
+    /**
+     * @brief reverseDesign
+     * Restores the state overwritten in the last cycle, and reverses any clocked components which manage their own
+     * reverse state. The circuit is not propagated.
+     */
+    void reverseDesign() {
+        m_reverseJournal.reverseCycle(
+            [this](const ReverseJournal::Entry& entry) { m_clockedComponents[entry.owner]->undo(entry); });
+        for (const auto& reg : m_clockedComponents) {
+            reg->reverse();
+        }
+        ClockedComponent::popReversibleCycle();
+        m_cycleCount--;
+    }
+
+    /**
+     * @brief replayForcedValues
+     * Reapplies the values recorded as forced at the current cycle, and propagates the circuit if any were.
+     */
+    void replayForcedValues() {
+        auto it = std::lower_bound(m_forcedValues.begin(), m_forcedValues.end(), m_cycleCount,
+                                   [](const ForcedValue& v, long long cycle) { return v.cycle < cycle; });
+        if (it == m_forcedValues.end() || it->cycle != m_cycleCount)
+            return;
+        for (; it != m_forcedValues.end() && it->cycle == m_cycleCount; it++)
+            m_clockedComponents[it->component]->forceValue(it->addr, it->value);
+        propagateDesign();
+    }
+
+    /**
+     * @brief clearHistory/truncateHistory
+     * Discards all checkpoints and forced values, respectively those recorded after the current cycle. Once cleared,
+     * a checkpoint of the current state is taken, if checkpointing is enabled.
+     */
+    void clearHistory() {
+        m_checkpoints.clear();
+        m_forcedValues.clear();
+        if (m_checkpointInterval != 0 && isVerifiedAndInitialized())
+            m_checkpoints.emplace(m_cycleCount, snapshot());
+    }
+
+    void truncateHistory() {
+        m_checkpoints.erase(m_checkpoints.upper_bound(m_cycleCount), m_checkpoints.end());
+        while (!m_forcedValues.empty() && m_forcedValues.back().cycle > m_cycleCount)
+            m_forcedValues.pop_back();
+    }
+
+    /**
+     * @brief createComponentGraph
+     * Gathers all components of the design in hierarchical pre-order. The hierarchy is traversed iteratively.
+     */
     void createComponentGraph() {
-        m_componentGraph.clear();
-        getComponentGraph(m_componentGraph);
+        m_components.clear();
+        std::vector<SimComponent*> pending;
+        for (const auto& c : getSubComponents())
+            pending.push_back(c);
+        std::reverse(pending.begin(), pending.end());
+        while (!pending.empty()) {
+            auto* c = pending.back();
+            pending.pop_back();
+            auto* comp = c->cast<Component>();
+            assert(comp && "Trying to verify unknown component");
+            m_components.push_back(comp);
 
-        // Gather all registers in the design
-        for (const auto& c : m_componentGraph) {
-            if (auto* cc = dynamic_cast<ClockedComponent*>(c.first)) {
-                m_clockedComponents.insert(cc);
+            const size_t first = pending.size();
+            for (const auto& sc : comp->getSubComponents())
+                pending.push_back(sc);
+            std::reverse(pending.begin() + first, pending.end());
+        }
+    }
+
+    /// Gathers the clocked components and registers of the design, in component graph order.
+    void collectClockedComponents() {
+        m_clockedComponents.clear();
+        m_registers.clear();
+        for (const auto& comp : m_components) {
+            // Only synchronous components may be clocked
+            if (!comp->isSynchronous())
+                continue;
+            if (auto* cc = dynamic_cast<ClockedComponent*>(comp)) {
+                m_clockedComponents.push_back(cc);
+                if (auto* rb = dynamic_cast<RegisterBase*>(cc))
+                    m_registers.push_back(rb);
             }
-            if (auto* rb = dynamic_cast<RegisterBase*>(c.first)) {
-                m_registers.insert(rb);
+        }
+    }
+
+    /**
+     * @brief scheduleHash
+     * The structural hash of the design, combined with the options which affect its schedule.
+     */
+    uint64_t scheduleHash(const ScheduleCache& cache) const {
+        uint64_t h = cache.structuralHash();
+        h = ScheduleCache::hash(h, static_cast<uint64_t>(m_eliminateUnobserved));
+        // Probes are ordered by address, which differs between processes
+        std::vector<uint32_t> probes;
+        for (const auto& probe : m_probes)
+            probes.push_back(cache.indexOf(probe));
+        std::sort(probes.begin(), probes.end());
+        for (const auto& probe : probes)
+            h = ScheduleCache::hash(h, probe);
+        for (const auto& rule : m_notifyRules) {
+            h = ScheduleCache::hash(h, rule.first);
+            h = ScheduleCache::hash(h, static_cast<uint64_t>(rule.second));
+        }
+        return h;
+    }
+
+    bool restoreSchedule(const ScheduleCache& cache, const std::string& path, uint64_t designHash) {
+        ScheduleCache::Schedule schedule;
+        if (!cache.read(path, designHash, schedule))
+            return false;
+        for (const auto& index : schedule.clockedComponents) {
+            if (!m_components[index]->isSynchronous())
+                return false;
+        }
+
+        for (const auto& index : schedule.propagationStack)
+            m_propagationStack.push_back(cache.portAt(index));
+        for (const auto& index : schedule.unobservedPorts)
+            m_unobservedPorts.push_back(cache.portAt(index));
+        for (const auto& alias : schedule.passThroughPorts)
+            m_passThroughPorts.push_back({cache.portAt(alias.first), cache.portAt(alias.second)});
+        // Component types are part of the hash, and so the cached indices refer to clocked components and registers
+        m_clockedComponents.clear();
+        m_registers.clear();
+        for (const auto& index : schedule.clockedComponents)
+            m_clockedComponents.push_back(static_cast<ClockedComponent*>(m_components[index]));
+        for (const auto& index : schedule.registers)
+            m_registers.push_back(static_cast<RegisterBase*>(m_components[index]));
+        return true;
+    }
+
+    void storeSchedule(const ScheduleCache& cache, const std::string& path, uint64_t designHash) const {
+        ScheduleCache::Schedule schedule;
+        for (const auto& p : m_propagationStack)
+            schedule.propagationStack.push_back(cache.indexOf(p));
+        for (const auto& p : m_unobservedPorts)
+            schedule.unobservedPorts.push_back(cache.indexOf(p));
+        for (const auto& alias : m_passThroughPorts)
+            schedule.passThroughPorts.push_back({cache.indexOf(alias.first), cache.indexOf(alias.second)});
+
+        std::unordered_map<const Component*, uint32_t> componentIndex;
+        for (uint32_t i = 0; i < m_components.size(); i++)
+            componentIndex.emplace(m_components[i], i);
+        for (const auto& c : m_clockedComponents)
+            schedule.clockedComponents.push_back(componentIndex.at(c));
+        for (const auto& r : m_registers)
+            schedule.registers.push_back(componentIndex.at(r));
+        ScheduleCache::write(path, designHash, schedule);
+    }
+
+    /**
+     * @brief relocatePortFunctions
+     * Moves the propagation functions of the ports of the propagation stack into m_portFunctions, in propagation
+     * order. See setRelocatePortData().
+     */
+    void relocatePortFunctions() {
+        const auto n = std::count_if(m_propagationStack.begin(), m_propagationStack.end(),
+                                     [](const PortBase* p) { return p->hasPropagationFunction(); });
+        // Sized once; ports point into the array
+        m_portFunctions = std::vector<PropagationFunction>(n);
+        size_t i = 0;
+        for (const auto& p : m_propagationStack) {
+            if (p->hasPropagationFunction())
+                p->relocateFunction(&m_portFunctions[i++]);
+        }
+    }
+
+    /**
+     * @brief createRegisterBank
+     * Relocates the state of all bankable registers into the register bank, which commits them when the design is
+     * clocked. All other clocked components are saved individually. The value table must have been created.
+     * Registers are banked in the order of m_clockedComponents (component graph order, see collectClockedComponents()),
+     * whose indices identify them in the reverse journal, and which is fixed once the design has been elaborated. The
+     * result of a commit does not depend on this order, since registers latch their inputs from the value table rather
+     * than from the state of other registers.
+     */
+    void createRegisterBank() {
+        m_savedComponents.clear();
+        std::vector<uint32_t> banked;
+        size_t enabled = 0;
+        for (uint32_t i = 0; i < m_clockedComponents.size(); i++) {
+            if (isBanked(m_clockedComponents[i])) {
+                banked.push_back(i);
+                enabled += static_cast<RegisterBase*>(m_clockedComponents[i])->getEnable() != nullptr;
+            } else {
+                m_savedComponents.push_back(m_clockedComponents[i]);
             }
         }
+
+        auto slotOf = [this](PortBase* port) {
+            if (port == nullptr)
+                return RegisterBank::s_none;
+            assert(port->valueSlot() >= m_portValues.data() &&
+                   port->valueSlot() < m_portValues.data() + m_portValues.size());
+            return static_cast<uint32_t>(port->valueSlot() - m_portValues.data());
+        };
+        m_registerBank.allocate(banked.size() - enabled, enabled);
+        for (const auto& i : banked) {
+            auto* reg = static_cast<RegisterBase*>(m_clockedComponents[i]);
+            auto* in = reg->getIn();
+            reg->relocateState(m_registerBank.add(slotOf(in), slotOf(reg->getOut()), generateBitmask(in->getWidth()),
+                                                  i, slotOf(reg->getEnable()), slotOf(reg->getClear())));
+        }
+    }
+
+    static bool isBanked(const ClockedComponent* c) {
+        auto* reg = dynamic_cast<const RegisterBase*>(c);
+        return reg && reg->bankable();
     }
 
-    std::map<SimComponent*, std::vector<SimComponent*>> m_componentGraph;
-    std::set<RegisterBase*> m_registers;
-    std::set<ClockedComponent*> m_clockedComponents;
+    /**
+     * @brief beginChangeSet/endChangeSet
+     * If change recording is requested, the value table is snapshotted prior to an operation on the design, and
+     * compared to the value table once the operation has completed. This is independent of the propagation mode.
+     */
+    void beginChangeSet() {
+        if (recordsChanges())
+            m_preChangeValues = m_portValues;
+    }
+
+    void endChangeSet() {
+        if (!recordsChanges() || m_preChangeValues.size() != m_portValues.size())
+            return;
+        m_changeSet.clear();
+        for (size_t i = 0; i < m_portValues.size(); i++) {
+            if ((m_portValues[i] ^ m_preChangeValues[i]) & m_slotMasks[i]) {
+                m_changeSet.push_back(m_slotPorts[i]);
+                for (const auto& alias : m_slotPorts[i]->aliases())
+                    m_changeSet.push_back(alias);
+            }
+        }
+        changeSetReady(m_changeSet);
+    }
+
+    void resolveNotifyPolicies() {
+        if (m_notifyRules.empty())
+            return;
+        for (const auto& c : m_components) {
+            // The hierarchical name of the component is shared by all of its ports
+            const std::string prefix = c->getHierName() + "->";
+            c->forEachPort([&](PortBase* p) {
+                const std::string name = prefix + p->getName();
+                for (const auto& rule : m_notifyRules) {
+                    if (name.find(rule.first) != std::string::npos)
+                        p->setNotifyPolicy(rule.second);
+                }
+            });
+        }
+    }
+
+    /**
+     * @brief createValueTable
+     * Relocates the values of all ports in the design into m_portValues. Ports in the propagation stack are assigned
+     * slots in propagation order, such that propagation walks the value table sequentially, followed by the unobserved
+     * ports. Pass-through ports share the slot of the port which they forward.
+     */
+    void createValueTable() {
+        size_t nSlots = 0;
+        for (const auto& c : m_components)
+            nSlots += c->portCount();
+        nSlots -= m_passThroughPorts.size();
+
+        m_portValues.resize(nSlots);
+        m_slotMasks.resize(nSlots);
+        m_slotPorts.clear();
+        m_slotPorts.reserve(nSlots);
+        auto assignSlot = [this](PortBase* p) {
+            const size_t slot = m_slotPorts.size();
+            p->relocateValue(&m_portValues[slot]);
+            m_slotMasks[slot] = generateBitmask(p->getWidth());
+            m_slotPorts.push_back(p);
+        };
+        for (const auto& p : m_propagationStack)
+            assignSlot(p);
+        for (const auto& p : m_unobservedPorts)
+            assignSlot(p);
+        // The ports forwarded by pass-through ports are always scheduled, and thus already have a slot
+        for (const auto& alias : m_passThroughPorts)
+            alias.first->aliasValue(alias.second);
+
+        // Any port whose value does not yet reside within the value table is assigned the next free slot
+        const VSRTL_VT_U* first = m_portValues.data();
+        const VSRTL_VT_U* last = first + nSlots;
+        for (const auto& c : m_components) {
+            c->forEachPort([&](PortBase* p) {
+                if (p->valueSlot() < first || p->valueSlot() >= last)
+                    assignSlot(p);
+            });
+        }
+        assert(m_slotPorts.size() == nSlots);
+    }
+
+    /**
+     * @brief preparePropagationMode
+     * Builds the structures used by the selected propagation mode, unless these have already been built. Large designs
+     * thereby only pay for elaborating the propagation modes which are actually used.
+     */
+    void preparePropagationMode() {
+        switch (m_propagationMode) {
+            case PropagationMode::activity:
+                if (!m_activityInitialized)
+                    initializeActivityPropagation();
+                break;
+            case PropagationMode::levelized:
+                if (m_levelizedPropagator.levelCount() == 0)
+                    initializeLevelizedPropagation(propagationDependencies());
+                break;
+            case PropagationMode::bitpacked:
+                bitNetlist();
+                break;
+            default:
+                break;
+        }
+    }
+
+    const PortGraph& portGraph() {
+        if (m_portGraph.nodeCount() == 0)
+            m_portGraph.build(m_components, m_portValues.data(), m_portValues.size());
+        return m_portGraph;
+    }
+
+    void initializeActivityPropagation() {
+        // Outputs of synchronous and stateful components are the sources of the port graph, and are reevaluated in
+        // every cycle; except for banked registers, which are reevaluated when the register bank reports a change.
+        std::vector<uint32_t> seeds;
+        for (uint32_t i = 0; i < m_propagationStack.size(); i++) {
+            auto* parent = m_propagationStack[i]->getParent<Component>();
+            if (parent && (parent->isSynchronous() || parent->isStateful()) &&
+                !isBanked(dynamic_cast<ClockedComponent*>(parent)))
+                seeds.push_back(i);
+        }
+        m_activityPropagator.initialize(m_propagationStack, portGraph(), seeds);
+        m_activityInitialized = true;
+    }
+
+    /**
+     * @brief propagationDependencies
+     * Returns, for each port of the propagation stack, the indices of the ports of the propagation stack which must be
+     * evaluated before it. Dependencies always precede their dependents in the propagation stack.
+     */
+    std::vector<std::vector<uint32_t>> propagationDependencies() {
+        const uint32_t n = static_cast<uint32_t>(m_propagationStack.size());
+        const auto& graph = portGraph();
+        std::vector<std::vector<uint32_t>> dependencies(n);
+        for (uint32_t i = 0; i < n; i++) {
+            for (const auto& reader : graph.readers(i)) {
+                if (reader < n)
+                    dependencies[reader].push_back(i);
+            }
+        }
+
+        for (uint32_t i = 0; i < n; i++) {
+            auto* parent = m_propagationStack[i]->getParent<Component>();
+            if (!parent || !parent->isSynchronous() || dynamic_cast<RegisterBase*>(parent))
+                continue;
+            // Besides registers, synchronous components may read their input ports while propagating their outputs (ie.
+            // synchronous read memories). The order between such an output and its inputs is retained from the
+            // propagation stack, such that reads observe the same values as in interpreted propagation.
+            for (const auto& in : parent->getInputPorts<PortBase>()) {
+                const uint32_t slot = static_cast<uint32_t>(in->valueSlot() - m_portValues.data());
+                if (slot >= n)
+                    continue;
+                if (slot < i)
+                    dependencies[i].push_back(slot);
+                else
+                    dependencies[slot].push_back(i);
+            }
+        }
+        return dependencies;
+    }
+
+    /**
+     * @brief initializeLevelizedPropagation
+     * Assigns each port of the propagation stack to the level following the deepest of its @p dependencies.
+     */
+    void initializeLevelizedPropagation(const std::vector<std::vector<uint32_t>>& dependencies) {
+        const uint32_t n = static_cast<uint32_t>(m_propagationStack.size());
+        std::vector<bool> serial(n, false);
+        for (uint32_t i = 0; i < n; i++) {
+            auto* parent = m_propagationStack[i]->getParent<Component>();
+            if (!parent)
+                continue;
+            // Stateful components may access shared state (ie. memories) which is not safe to access concurrently, and
+            // synchronous components other than registers must observe their inputs in propagation-stack order.
+            const bool isRegister = dynamic_cast<RegisterBase*>(parent) != nullptr;
+            serial[i] = parent->isStateful() || (parent->isSynchronous() && !isRegister);
+        }
+
+        std::vector<uint32_t> levels(n, 0);
+        for (uint32_t i = 0; i < n; i++) {
+            for (const auto& dep : dependencies[i])
+                levels[i] = std::max(levels[i], levels[dep] + 1);
+        }
+        m_levelizedPropagator.initialize(m_flatNetlist, levels, serial);
+    }
+
+    std::vector<Component*> m_components;
+    std::vector<std::pair<std::string, std::chrono::nanoseconds>> m_elaborationTimes;
+    std::string m_scheduleCacheDirectory;
+    bool m_scheduleRestored = false;
+    std::vector<RegisterBase*> m_registers;
+    std::vector<ClockedComponent*> m_clockedComponents;
+    ReverseJournal m_reverseJournal;
+    RegisterBank m_registerBank;
+    /// Clocked components which are not committed through the register bank, and are thus clocked through save().
+    std::vector<ClockedComponent*> m_savedComponents;
     std::vector<std::unique_ptr<AddressSpace>> m_memories;
+    BreakpointEngine m_breakpoints;
+#ifdef VSRTL_PROFILING
+    Profiler m_profiler;
+    /// Counters of m_savedComponents, in the same order.
+    std::vector<ProfileCounter*> m_saveProfiles;
+    ProfileCounter* m_registerBankProfile = nullptr;
+#endif
+
+    /// Leading word of blobs created by snapshot() ("VSNP")
+    static constexpr uint64_t s_snapshotMagic = 0x56534e50;
+
+    /// A value forced through setSynchronousValue(), as replayed by seek().
+    struct ForcedValue {
+        long long cycle;
+        uint32_t component;
+        VSRTL_VT_U addr;
+        VSRTL_VT_U value;
+    };
+    unsigned m_checkpointInterval = 0;
+    /// Snapshots of the design, by cycle.
+    std::map<long long, std::vector<uint8_t>> m_checkpoints;
+    /// Values forced since the last reset, in order of cycle.
+    std::vector<ForcedValue> m_forcedValues;
 
     std::vector<PortBase*> m_propagationStack;
+    /// Ports removed from the propagation stack, and the port whose value each of them forwards.
+    std::vector<std::pair<PortBase*, PortBase*>> m_passThroughPorts;
+    /// Ports removed from the propagation stack by eliminateUnobservedPorts(), in propagation order.
+    std::vector<PortBase*> m_unobservedPorts;
+    /// Whether unobserved ports are propagated regardless of signals and change sets, as required by runCycles().
+    bool m_propagateUnobserved = false;
+    std::set<const PortBase*> m_probes;
+    size_t m_foldedComponentCount = 0;
+    bool m_eliminateUnobserved = false;
+    bool m_relocatePortData = false;
+    std::vector<std::pair<std::string, PortBase::NotifyPolicy>> m_notifyRules = {
+        {"MIPS", PortBase::NotifyPolicy::always}};
+
+    /// Values of all ports in the design. Must not be resized after ports have been relocated.
+    std::vector<VSRTL_VT_U> m_portValues;
+    /// Propagation functions of the scheduled ports, in propagation order, if relocated (see setRelocatePortData()).
+    std::vector<PropagationFunction> m_portFunctions;
+    /// Port and width mask of each slot in the value table.
+    std::vector<PortBase*> m_slotPorts;
+    std::vector<VSRTL_VT_U> m_slotMasks;
+    std::vector<VSRTL_VT_U> m_preChangeValues;
+    std::vector<SimPort*> m_changeSet;
+    FlatNetlist m_flatNetlist;
+    PortGraph m_portGraph;
+    ActivityPropagator m_activityPropagator;
+    bool m_activityInitialized = false;
+    LevelizedPropagator m_levelizedPropagator;
+    NativeNetlist m_nativeNetlist;
+    BitNetlist m_bitNetlist;
+    PropagationMode m_propagationMode = PropagationMode::interpreted;
 };
 
 }  // namespace core
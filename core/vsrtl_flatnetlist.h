@@ -0,0 +1,94 @@
+#ifndef VSRTL_FLATNETLIST_H
+#define VSRTL_FLATNETLIST_H
+
+#include "../interface/vsrtl_binutils.h"
+#include "../interface/vsrtl_defines.h"
+#include "vsrtl_port.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The FlatNetlist class
+ * A lowered representation of the propagation stack of a design. All port values reside in the contiguous value table
+ * of the design, and propagation is performed by sequentially executing a compact tape of instructions over this
+ * table. Each instruction either copies the value of a source slot, or calls the propagation function of the port
+ * owning the destination slot. In both cases, the resulting value is masked to the width of the destination port.
+ *
+ * Lowering happens once after the propagation stack has been created; the tape holds no pointers to ports, which
+ * means that executing it involves no virtual calls nor any pointer chasing through the circuit graph.
+ */
+class FlatNetlist {
+public:
+    enum class OpCode : uint8_t { copy, call };
+
+    struct Instruction {
+        OpCode code;
+        uint32_t dst;
+        uint32_t src;
+        VSRTL_VT_U mask;
+        const PropagationFunction* function;
+    };
+
+    /**
+     * @brief lower
+     * Generates the instruction tape for @p propagationStack. Ports (and their input ports) must have been relocated
+     * to slots within @p values prior to lowering.
+     */
+    void lower(const std::vector<PortBase*>& propagationStack, VSRTL_VT_U* values) {
+        m_values = values;
+        m_tape.clear();
+        m_tape.reserve(propagationStack.size());
+
+        for (const auto& port : propagationStack) {
+            Instruction instr;
+            instr.dst = slotOf(port);
+            instr.mask = generateBitmask(port->getWidth());
+            instr.function = nullptr;
+            instr.src = 0;
+            if (port->hasPropagationFunction()) {
+                instr.code = OpCode::call;
+                instr.function = &port->getPropagationFunction();
+            } else {
+                instr.code = OpCode::copy;
+                instr.src = slotOf(port->getInputPort<PortBase>());
+            }
+            m_tape.push_back(instr);
+        }
+    }
+
+    void execute() const {
+        VSRTL_VT_U* const values = m_values;
+        for (const auto& instr : m_tape)
+            execute(instr, values);
+    }
+
+    static void execute(const Instruction& instr, VSRTL_VT_U* values) {
+        switch (instr.code) {
+            case OpCode::copy:
+                values[instr.dst] = values[instr.src] & instr.mask;
+                break;
+            case OpCode::call:
+                values[instr.dst] = (*instr.function)() & instr.mask;
+                break;
+        }
+    }
+
+    bool isLowered() const { return m_values != nullptr; }
+    const std::vector<Instruction>& tape() const { return m_tape; }
+    VSRTL_VT_U* values() const { return m_values; }
+
+private:
+    uint32_t slotOf(const PortBase* port) const { return static_cast<uint32_t>(port->valueSlot() - m_values); }
+
+    VSRTL_VT_U* m_values = nullptr;
+    std::vector<Instruction> m_tape;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_FLATNETLIST_H
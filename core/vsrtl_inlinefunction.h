@@ -0,0 +1,93 @@
+#ifndef VSRTL_INLINEFUNCTION_H
+#define VSRTL_INLINEFUNCTION_H
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace vsrtl {
+namespace core {
+
+template <typename Signature, std::size_t Capacity>
+class InlineFunction;
+
+/**
+ * @brief The InlineFunction class
+ * A non-allocating replacement for std::function. The callable is stored within a fixed-capacity buffer inside the
+ * InlineFunction itself; callables which do not fit are rejected at compile time. Invocation is a single indirect call
+ * through a function pointer specific to the stored callable type.
+ */
+template <typename R, typename... Args, std::size_t Capacity>
+class InlineFunction<R(Args...), Capacity> {
+public:
+    InlineFunction() = default;
+    InlineFunction(std::nullptr_t) {}
+
+    template <typename F, typename D = std::decay_t<F>,
+              typename = std::enable_if_t<!std::is_same<D, InlineFunction>::value>>
+    InlineFunction(F&& f) {
+        static_assert(sizeof(D) <= Capacity,
+                      "Callable exceeds the capacity of InlineFunction; capture fewer values by copy (ie. capture "
+                      "'this' and access members instead)");
+        static_assert(alignof(D) <= alignof(void*), "Callable is over-aligned");
+        new (m_storage) D(std::forward<F>(f));
+        m_invoke = [](void* storage, Args... args) -> R {
+            return (*static_cast<D*>(storage))(std::forward<Args>(args)...);
+        };
+        if (!std::is_trivially_copyable<D>::value || !std::is_trivially_destructible<D>::value) {
+            m_manage = [](void* dst, void* src) {
+                if (dst)
+                    new (dst) D(std::move(*static_cast<D*>(src)));
+                static_cast<D*>(src)->~D();
+            };
+        }
+    }
+
+    InlineFunction(InlineFunction&& other) noexcept { moveFrom(other); }
+    InlineFunction& operator=(InlineFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+    InlineFunction(const InlineFunction&) = delete;
+    InlineFunction& operator=(const InlineFunction&) = delete;
+
+    ~InlineFunction() { reset(); }
+
+    R operator()(Args... args) const { return m_invoke(m_storage, std::forward<Args>(args)...); }
+    explicit operator bool() const { return m_invoke != nullptr; }
+
+private:
+    void reset() {
+        if (m_manage)
+            m_manage(nullptr, m_storage);
+        m_invoke = nullptr;
+        m_manage = nullptr;
+    }
+
+    void moveFrom(InlineFunction& other) {
+        if (other.m_manage)
+            other.m_manage(m_storage, other.m_storage);
+        else
+            std::memcpy(m_storage, other.m_storage, Capacity);
+        m_invoke = other.m_invoke;
+        m_manage = other.m_manage;
+        other.m_invoke = nullptr;
+        other.m_manage = nullptr;
+    }
+
+    // Mutable, such that stateful (mutable) callables may be invoked through a const InlineFunction, as is the case
+    // for std::function.
+    alignas(void*) mutable unsigned char m_storage[Capacity];
+    R (*m_invoke)(void*, Args...) = nullptr;
+    void (*m_manage)(void* dst, void* src) = nullptr;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_INLINEFUNCTION_H
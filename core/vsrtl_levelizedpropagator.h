@@ -0,0 +1,239 @@
+#ifndef VSRTL_LEVELIZEDPROPAGATOR_H
+#define VSRTL_LEVELIZEDPROPAGATOR_H
+
+#include "../interface/vsrtl_defines.h"
+#include "vsrtl_flatnetlist.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The LevelizedPropagator class
+ * Propagates a design by evaluating its flat netlist level by level. No port within a level depends on any other port
+ * within the same level, and so the instructions of a level may be executed concurrently. Levels which are wider than
+ * the parallel threshold are distributed across a persistent pool of worker threads, with a single barrier at the end
+ * of each level. Narrow levels, as well as instructions which are not safe to execute concurrently (ie. reading from a
+ * memory), are executed by the calling thread.
+ */
+class LevelizedPropagator {
+public:
+    ~LevelizedPropagator() { stopWorkers(); }
+
+    /**
+     * @brief initialize
+     * @param netlist: lowered netlist of the design.
+     * @param levels: level of each instruction of the netlist.
+     * @param serial: whether each instruction of the netlist must be executed on the calling thread.
+     */
+    void initialize(const FlatNetlist& netlist, const std::vector<uint32_t>& levels, const std::vector<bool>& serial) {
+        m_netlist = &netlist;
+        const auto& tape = netlist.tape();
+        const uint32_t nLevels = tape.empty() ? 0 : *std::max_element(levels.begin(), levels.end()) + 1;
+
+        m_levels.assign(nLevels, {});
+        for (size_t i = 0; i < tape.size(); i++) {
+            auto& level = m_levels[levels[i]];
+            (serial[i] ? level.serial : level.parallel).push_back(tape[i]);
+        }
+        buildStages();
+    }
+
+    /**
+     * @brief setThreadCount
+     * Sets the total number of threads (including the calling thread) used for propagation.
+     */
+    void setThreadCount(unsigned threads) {
+        threads = std::max(1u, threads);
+        if (threads == m_threadCount)
+            return;
+        stopWorkers();
+        m_threadCount = threads;
+    }
+    unsigned threadCount() const { return m_threadCount; }
+
+    /**
+     * @brief setParallelThreshold
+     * Levels with fewer than @p width instructions are executed by the calling thread; the cost of synchronizing with
+     * the worker threads would outweigh the gain of evaluating such levels concurrently.
+     */
+    void setParallelThreshold(unsigned width) {
+        m_parallelThreshold = width;
+        buildStages();
+    }
+    unsigned parallelThreshold() const { return m_parallelThreshold; }
+
+    size_t levelCount() const { return m_levels.size(); }
+
+    void propagate() {
+        if (m_threadCount > 1 && m_parallelStages != 0 && m_workers.empty())
+            startWorkers();
+
+        if (m_workers.empty() || m_parallelStages == 0) {
+            for (const auto& stage : m_stages)
+                executeStage(stage);
+            return;
+        }
+
+        for (auto& stage : m_stages)
+            stage.next.store(0, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_generation++;
+        }
+        m_wake.notify_all();
+        run(true);
+    }
+
+private:
+    struct Level {
+        std::vector<FlatNetlist::Instruction> serial;
+        std::vector<FlatNetlist::Instruction> parallel;
+    };
+
+    /// A stage is either a single wide level, or a sequence of narrow levels which is executed by the calling thread.
+    struct Stage {
+        Stage() = default;
+        Stage(const Stage& other)
+            : instructions(other.instructions), serial(other.serial), isParallel(other.isParallel) {}
+        std::vector<FlatNetlist::Instruction> instructions;
+        std::vector<FlatNetlist::Instruction> serial;
+        bool isParallel = false;
+        std::atomic<uint32_t> next{0};
+    };
+
+    static constexpr uint32_t s_chunkSize = 64;
+
+    void buildStages() {
+        m_stages.clear();
+        m_parallelStages = 0;
+        for (const auto& level : m_levels) {
+            if (level.parallel.size() >= m_parallelThreshold) {
+                auto& stage = m_stages.emplace_back();
+                stage.isParallel = true;
+                stage.instructions = level.parallel;
+                stage.serial = level.serial;
+                m_parallelStages++;
+            } else {
+                if (m_stages.empty() || m_stages.back().isParallel)
+                    m_stages.emplace_back();
+                auto& stage = m_stages.back();
+                stage.serial.insert(stage.serial.end(), level.serial.begin(), level.serial.end());
+                stage.serial.insert(stage.serial.end(), level.parallel.begin(), level.parallel.end());
+            }
+        }
+    }
+
+    static void execute(const FlatNetlist::Instruction* first, const FlatNetlist::Instruction* last,
+                        VSRTL_VT_U* values) {
+        for (; first != last; ++first)
+            FlatNetlist::execute(*first, values);
+    }
+
+    void executeStage(const Stage& stage) {
+        VSRTL_VT_U* values = m_netlist->values();
+        execute(stage.serial.data(), stage.serial.data() + stage.serial.size(), values);
+        execute(stage.instructions.data(), stage.instructions.data() + stage.instructions.size(), values);
+    }
+
+    /**
+     * @brief run
+     * Executes all stages of the design. Executed by all threads in the pool, including the calling thread.
+     */
+    void run(bool isCaller) {
+        VSRTL_VT_U* values = m_netlist->values();
+        for (auto& stage : m_stages) {
+            if (!stage.isParallel) {
+                if (isCaller)
+                    executeStage(stage);
+            } else {
+                if (isCaller)
+                    execute(stage.serial.data(), stage.serial.data() + stage.serial.size(), values);
+                const uint32_t n = static_cast<uint32_t>(stage.instructions.size());
+                uint32_t first;
+                while ((first = stage.next.fetch_add(s_chunkSize, std::memory_order_relaxed)) < n) {
+                    const uint32_t last = std::min(n, first + s_chunkSize);
+                    execute(stage.instructions.data() + first, stage.instructions.data() + last, values);
+                }
+            }
+            barrier();
+        }
+    }
+
+    void barrier() {
+        const unsigned generation = m_barrierGeneration.load(std::memory_order_acquire);
+        if (m_barrierCount.fetch_add(1, std::memory_order_acq_rel) + 1 == m_threadCount) {
+            m_barrierCount.store(0, std::memory_order_relaxed);
+            m_barrierGeneration.fetch_add(1, std::memory_order_release);
+        } else {
+            while (m_barrierGeneration.load(std::memory_order_acquire) == generation)
+                std::this_thread::yield();
+        }
+    }
+
+    /// @p seenGeneration is the generation at which the worker was started; it runs once the generation is bumped.
+    void worker(unsigned seenGeneration) {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [&] { return m_stop || m_generation != seenGeneration; });
+                if (m_stop)
+                    return;
+                seenGeneration = m_generation;
+            }
+            run(false);
+        }
+    }
+
+    void startWorkers() {
+        unsigned generation;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = false;
+            generation = m_generation;
+        }
+        m_barrierCount = 0;
+        m_barrierGeneration = 0;
+        for (unsigned i = 1; i < m_threadCount; i++)
+            m_workers.emplace_back(&LevelizedPropagator::worker, this, generation);
+    }
+
+    void stopWorkers() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto& t : m_workers)
+            t.join();
+        m_workers.clear();
+    }
+
+    const FlatNetlist* m_netlist = nullptr;
+    std::vector<Level> m_levels;
+    std::vector<Stage> m_stages;
+    unsigned m_parallelStages = 0;
+    unsigned m_parallelThreshold = 256;
+    unsigned m_threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    unsigned m_generation = 0;
+    bool m_stop = false;
+    std::atomic<unsigned> m_barrierCount{0};
+    std::atomic<unsigned> m_barrierGeneration{0};
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_LEVELIZEDPROPAGATOR_H
@@ -12,6 +12,21 @@ public:
     LogicGate(const std::string& name, SimComponent* parent) : Component(name, parent) {}
     OUTPUTPORT(out, W);
     INPUTPORTS(in, W, nInputs);
+
+protected:
+    BatchPrimitive primitive(BatchPrimitive::Op op) const {
+        BatchPrimitive p;
+        p.op = op;
+        p.operands.assign(in.begin(), in.end());
+        return p;
+    }
+
+    std::string foldInputs(const std::string& op, const NativeOperand& operand) const {
+        std::string expr = "(" + operand(in[0]);
+        for (unsigned i = 1; i < in.size(); i++)
+            expr += " " + op + " " + operand(in[i]);
+        return expr + ")";
+    }
 };
 
 template <unsigned int W, unsigned int nInputs>
@@ -26,6 +41,14 @@ public:
             return v;
         };
     }
+
+    std::string nativeExpression(const PortBase*, const Component::NativeOperand& operand) const override {
+        return this->foldInputs("&", operand);
+    }
+
+    Component::BatchPrimitive batchPrimitive(const PortBase*) const override {
+        return this->primitive(Component::BatchPrimitive::Op::bitAnd);
+    }
 };
 
 template <unsigned int W, unsigned int nInputs>
@@ -40,6 +63,14 @@ public:
             return ~v;
         };
     }
+
+    std::string nativeExpression(const PortBase*, const Component::NativeOperand& operand) const override {
+        return "~" + this->foldInputs("&", operand);
+    }
+
+    Component::BatchPrimitive batchPrimitive(const PortBase*) const override {
+        return this->primitive(Component::BatchPrimitive::Op::bitNand);
+    }
 };
 
 template <unsigned int W, unsigned int nInputs>
@@ -55,6 +86,14 @@ public:
             return v;
         };
     }
+
+    std::string nativeExpression(const PortBase*, const Component::NativeOperand& operand) const override {
+        return this->foldInputs("|", operand);
+    }
+
+    Component::BatchPrimitive batchPrimitive(const PortBase*) const override {
+        return this->primitive(Component::BatchPrimitive::Op::bitOr);
+    }
 };
 
 template <unsigned int W, unsigned int nInputs>
@@ -70,6 +109,14 @@ public:
             return v;
         };
     }
+
+    std::string nativeExpression(const PortBase*, const Component::NativeOperand& operand) const override {
+        return this->foldInputs("^", operand);
+    }
+
+    Component::BatchPrimitive batchPrimitive(const PortBase*) const override {
+        return this->primitive(Component::BatchPrimitive::Op::bitXor);
+    }
 };
 
 template <unsigned int W, unsigned int nInputs>
@@ -79,6 +126,14 @@ public:
     Not(const std::string& name, SimComponent* parent) : LogicGate<W, nInputs>(name, parent) {
         this->out << [=] { return ~this->in[0]->uValue(); };
     }
+
+    std::string nativeExpression(const PortBase*, const Component::NativeOperand& operand) const override {
+        return "~" + operand(this->in[0]);
+    }
+
+    Component::BatchPrimitive batchPrimitive(const PortBase*) const override {
+        return this->primitive(Component::BatchPrimitive::Op::bitNot);
+    }
 };
 
 }  // namespace core
@@ -0,0 +1,185 @@
+#ifndef VSRTL_LOOPDETECTOR_H
+#define VSRTL_LOOPDETECTOR_H
+
+#include "vsrtl_component.h"
+#include "vsrtl_port.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The LoopDetector class
+ * Detects combinational loops within a design. The port-level dependency graph of the design (see PortGraph) is built
+ * prior to elaboration, and its strongly connected components are found through an iterative formulation of Tarjan's
+ * algorithm. Any strongly connected component of more than one port (or of a port which depends on itself) is a
+ * combinational loop. Both building and searching the graph are linear in the number of ports and connections.
+ */
+class LoopDetector {
+public:
+    using Loop = std::vector<const PortBase*>;
+
+    /**
+     * @brief findLoops
+     * @returns all combinational loops between the ports of @p components. Ports of each loop are listed in the order
+     * in which the loop is traversed.
+     */
+    std::vector<Loop> findLoops(const std::vector<Component*>& components) {
+        build(components);
+        return stronglyConnectedComponents();
+    }
+
+private:
+    void build(const std::vector<Component*>& components) {
+        m_ports.clear();
+        m_index.clear();
+        size_t nPorts = 0;
+        for (const auto& c : components)
+            nPorts += c->portCount();
+        m_ports.reserve(nPorts);
+        m_index.reserve(nPorts);
+        for (const auto& c : components) {
+            c->forEachPort([this](const PortBase* p) {
+                m_index.emplace(p, static_cast<uint32_t>(m_ports.size()));
+                m_ports.push_back(p);
+            });
+        }
+
+        std::vector<std::pair<uint32_t, uint32_t>> edges;
+        auto indexOf = [this](const PortBase* p) {
+            auto it = m_index.find(p);
+            return it == m_index.end() ? s_none : it->second;
+        };
+        auto addEdge = [&](const PortBase* from, const PortBase* to) {
+            const uint32_t a = indexOf(from);
+            const uint32_t b = indexOf(to);
+            if (a != s_none && b != s_none)
+                edges.push_back({a, b});
+        };
+
+        // Edges mirror those of the port graph; the graph is cut at synchronous components
+        uint32_t index = 0;
+        for (const auto& c : components) {
+            c->forEachPort([&](const PortBase* p) {
+                // Ports are visited in the order in which they were indexed
+                const uint32_t from = index++;
+                for (const auto& sink : p->drivenPorts()) {
+                    const auto* sinkPort = static_cast<const PortBase*>(sink);
+                    if (sinkPort->hasPropagationFunction())
+                        continue;
+                    const uint32_t to = indexOf(sinkPort);
+                    if (to != s_none)
+                        edges.push_back({from, to});
+                }
+            });
+
+            if (c->isSynchronous())
+                continue;
+
+            for (const auto& out : c->getOutputPorts<PortBase>()) {
+                if (!out->hasPropagationFunction())
+                    continue;
+                for (const auto& in : c->getInputPorts<PortBase>())
+                    addEdge(in, out);
+                for (const auto& sens : c->getSensitivityList())
+                    addEdge(sens, out);
+            }
+        }
+
+        const size_t n = m_ports.size();
+        m_offsets.assign(n + 1, 0);
+        for (const auto& e : edges)
+            m_offsets[e.first + 1]++;
+        for (size_t i = 0; i < n; i++)
+            m_offsets[i + 1] += m_offsets[i];
+        m_targets.resize(edges.size());
+        std::vector<uint32_t> fill(m_offsets.begin(), m_offsets.end() - 1);
+        for (const auto& e : edges)
+            m_targets[fill[e.first]++] = e.second;
+    }
+
+    std::vector<Loop> stronglyConnectedComponents() const {
+        const uint32_t n = static_cast<uint32_t>(m_ports.size());
+        std::vector<uint32_t> index(n, s_none);
+        std::vector<uint32_t> lowLink(n, 0);
+        std::vector<bool> onStack(n, false);
+        std::vector<uint32_t> sccStack;
+        // Explicit DFS stack of (node, next edge to visit)
+        std::vector<std::pair<uint32_t, uint32_t>> dfs;
+        std::vector<Loop> loops;
+        uint32_t nextIndex = 0;
+
+        for (uint32_t root = 0; root < n; root++) {
+            if (index[root] != s_none)
+                continue;
+            dfs.push_back({root, m_offsets[root]});
+            index[root] = lowLink[root] = nextIndex++;
+            sccStack.push_back(root);
+            onStack[root] = true;
+
+            while (!dfs.empty()) {
+                auto& frame = dfs.back();
+                const uint32_t v = frame.first;
+                if (frame.second < m_offsets[v + 1]) {
+                    const uint32_t w = m_targets[frame.second++];
+                    if (index[w] == s_none) {
+                        index[w] = lowLink[w] = nextIndex++;
+                        sccStack.push_back(w);
+                        onStack[w] = true;
+                        dfs.push_back({w, m_offsets[w]});
+                    } else if (onStack[w]) {
+                        lowLink[v] = std::min(lowLink[v], index[w]);
+                    }
+                    continue;
+                }
+
+                dfs.pop_back();
+                if (!dfs.empty())
+                    lowLink[dfs.back().first] = std::min(lowLink[dfs.back().first], lowLink[v]);
+                if (lowLink[v] != index[v])
+                    continue;
+
+                Loop scc;
+                uint32_t w;
+                do {
+                    w = sccStack.back();
+                    sccStack.pop_back();
+                    onStack[w] = false;
+                    scc.push_back(m_ports[w]);
+                } while (w != v);
+
+                if (scc.size() > 1 || dependsOnItself(v)) {
+                    // Ports are popped in reverse order of discovery
+                    std::reverse(scc.begin(), scc.end());
+                    loops.push_back(std::move(scc));
+                }
+            }
+        }
+        return loops;
+    }
+
+    bool dependsOnItself(uint32_t v) const {
+        for (uint32_t e = m_offsets[v]; e < m_offsets[v + 1]; e++) {
+            if (m_targets[e] == v)
+                return true;
+        }
+        return false;
+    }
+
+    static constexpr uint32_t s_none = UINT32_MAX;
+
+    std::vector<const PortBase*> m_ports;
+    std::unordered_map<const PortBase*, uint32_t> m_index;
+    std::vector<uint32_t> m_offsets;
+    std::vector<uint32_t> m_targets;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_LOOPDETECTOR_H
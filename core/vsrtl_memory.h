@@ -3,6 +3,7 @@
 
 #include "vsrtl_addressspace.h"
 #include "vsrtl_component.h"
+#include "vsrtl_profiler.h"
 #include "vsrtl_register.h"
 
 #include "../interface/vsrtl_defines.h"
@@ -14,14 +15,6 @@
 namespace vsrtl {
 namespace core {
 
-// A memory eviction contains information about data that was overwritten in a given cycle.
-struct MemoryEviction {
-    long long cycle;
-    VSRTL_VT_U addr;
-    VSRTL_VT_U data;
-    VSRTL_VT_U width;
-};
-
 template <bool byteIndexed = true>
 class BaseMemory {
 public:
@@ -32,10 +25,12 @@ public:
     virtual AddressSpace::RegionType accessRegion() const = 0;
 
     VSRTL_VT_U read(VSRTL_VT_U address, int size, unsigned wordShift) {
+        VSRTL_PROFILE(m_readProfile);
         return m_memory->readMem(byteIndexed ? address : address << wordShift, size);
     }
 
     void write(VSRTL_VT_U address, VSRTL_VT_U value, int size, unsigned wordShift) {
+        VSRTL_PROFILE(m_writeProfile);
         m_memory->writeMem(byteIndexed ? address : address << wordShift, value, size);
     }
 
@@ -44,8 +39,19 @@ public:
     virtual VSRTL_VT_U wrEnSig() const = 0;
     virtual VSRTL_VT_U opSig() const { return 0; };
 
+#ifdef VSRTL_PROFILING
+    void setProfileCounters(ProfileCounter* reads, ProfileCounter* writes) {
+        m_readProfile = reads;
+        m_writeProfile = writes;
+    }
+#endif
+
 protected:
     AddressSpace* m_memory = nullptr;
+#ifdef VSRTL_PROFILING
+    ProfileCounter* m_readProfile = nullptr;
+    ProfileCounter* m_writeProfile = nullptr;
+#endif
 };
 
 template <unsigned int addrWidth, unsigned int dataWidth, bool byteIndexed = true>
@@ -53,7 +59,7 @@ class WrMemory : public ClockedComponent, public BaseMemory<byteIndexed> {
 public:
     SetGraphicsType(Component);
     WrMemory(const std::string& name, SimComponent* parent) : ClockedComponent(name, parent) {}
-    void reset() override { m_reverseStack.clear(); }
+    void reset() override {}
     AddressSpace::RegionType accessRegion() const override { return this->memory()->regionType(addr.uValue()); }
 
     void save() override {
@@ -64,25 +70,18 @@ public:
             const VSRTL_VT_U data_in_v = data_in.uValue();
             const VSRTL_VT_U data_out_v = this->read(addr_v, dataWidth / CHAR_BIT, wordshift);
             const VSRTL_VT_U wr_width_v = wr_width.uValue();
-            // save() is called prior to cycle incrementation; WrMemory::reverse() relies on an eviction being listed
-            // for the cycle which the 'reverse' call happened in.´
-            const auto cycle = getDesign()->getCycleCount() + 1;
-            auto ev = MemoryEviction({cycle, addr_v, data_out_v, wr_width_v});
-            saveToStack(ev);
+            // The overwritten data is journaled, such that it is written back when reversing the cycle. Writes which
+            // leave the written bytes unchanged need not be reversed.
+            if ((data_out_v ^ data_in_v) & generateBitmask(wr_width_v * CHAR_BIT))
+                journal(data_out_v, addr_v, static_cast<uint32_t>(wr_width_v));
             this->write(addr_v, data_in_v, wr_width_v, wordshift);
         }
     }
 
-    void reverse() override {
-        if (m_reverseStack.size() > 0) {
-            auto lastEviction = m_reverseStack.front();
-            auto cycle = getDesign()->getCycleCount();
-            if (lastEviction.cycle == cycle) {
-                this->write(lastEviction.addr, lastEviction.data, lastEviction.width,
-                            ceillog2((byteIndexed ? addrWidth : dataWidth) / CHAR_BIT));
-                m_reverseStack.pop_front();
-            }
-        }
+    // Memory contents are reversed through the reverse journal of the design
+    void reverse() override {}
+    void undo(const ReverseJournal::Entry& entry) override {
+        this->write(entry.key, entry.value, entry.tag, ceillog2((byteIndexed ? addrWidth : dataWidth) / CHAR_BIT));
     }
 
     virtual VSRTL_VT_U addressSig() const override { return addr.uValue(); };
@@ -96,23 +95,6 @@ public:
     INPUTPORT(data_in, dataWidth);
     INPUTPORT(wr_width, ceillog2(dataWidth / CHAR_BIT + 1));  // # bytes
     INPUTPORT(wr_en, 1);
-
-protected:
-    void reverseStackSizeChanged() override {
-        if (reverseStackSize() < m_reverseStack.size()) {
-            m_reverseStack.resize(m_reverseStack.size());
-        }
-    }
-
-private:
-    void saveToStack(MemoryEviction v) {
-        m_reverseStack.push_front(v);
-        if (m_reverseStack.size() > reverseStackSize()) {
-            m_reverseStack.pop_back();
-        }
-    }
-
-    std::deque<MemoryEviction> m_reverseStack;
 };
 
 template <unsigned int addrWidth, unsigned int dataWidth, bool byteIndexed = true>
@@ -140,6 +122,7 @@ class RdMemory : public Component, public BaseMemory<byteIndexed> {
 public:
     SetGraphicsType(ClockedComponent);
     RdMemory(const std::string& name, SimComponent* parent) : Component(name, parent) {
+        setStateful();
         data_out << [=] {
             auto _addr = addr.uValue();
             auto val =
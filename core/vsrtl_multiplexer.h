@@ -58,6 +58,21 @@ public:
     PortBase* getSelect() override { return &select; }
     PortBase* getOut() override { return &out; }
 
+    std::string nativeExpression(const PortBase*, const NativeOperand& operand) const override {
+        // Out-of-range select values throw, as does ins.at() in the propagation function
+        const std::string sel = operand(&select);
+        std::string expr = "(";
+        for (unsigned i = 0; i < ins.size(); i++)
+            expr += sel + " == " + std::to_string(i) + "u ? " + operand(ins[i]) + " : ";
+        return expr + "vsrtl_out_of_range())";
+    }
+
+    BatchPrimitive batchPrimitive(const PortBase*) const override {
+        BatchPrimitive p{BatchPrimitive::Op::mux, {&select}, 0};
+        p.operands.insert(p.operands.end(), ins.begin(), ins.end());
+        return p;
+    }
+
     OUTPUTPORT(out, W);
     INPUTPORT(select, ceillog2(N));
     INPUTPORTS(ins, W, N);
@@ -109,6 +124,21 @@ public:
     PortBase* getSelect() override { return &select; }
     PortBase* getOut() override { return &out; }
 
+    std::string nativeExpression(const PortBase*, const NativeOperand& operand) const override {
+        // Out-of-range select values throw, as does ins.at() in the propagation function
+        const std::string sel = operand(&select);
+        std::string expr = "(";
+        for (unsigned i = 0; i < ins.size(); i++)
+            expr += sel + " == " + std::to_string(i) + "u ? " + operand(ins[i]) + " : ";
+        return expr + "vsrtl_out_of_range())";
+    }
+
+    BatchPrimitive batchPrimitive(const PortBase*) const override {
+        BatchPrimitive p{BatchPrimitive::Op::mux, {&select}, 0};
+        p.operands.insert(p.operands.end(), ins.begin(), ins.end());
+        return p;
+    }
+
     OUTPUTPORT(out, W);
     INPUTPORT_ENUM(select, E_t);
     INPUTPORTS(ins, W, E_t::_size());
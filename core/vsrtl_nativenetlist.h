@@ -0,0 +1,177 @@
+#ifndef VSRTL_NATIVENETLIST_H
+#define VSRTL_NATIVENETLIST_H
+
+#include "../interface/vsrtl_binutils.h"
+#include "../interface/vsrtl_defines.h"
+#include "vsrtl_component.h"
+#include "vsrtl_port.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <dlfcn.h>
+#include <unistd.h>
+#endif
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The NativeNetlist class
+ * Compiles the propagation stack of a design to native code. A self-contained C++ translation unit is generated, in
+ * which the propagation stack is emitted as straight-line code operating on the value table of the design; each port
+ * is an element of the value table. The translation unit is built into a shared library using the system compiler,
+ * and loaded at runtime.
+ *
+ * Ports of components which provide a native expression (see Component::nativeExpression()) are inlined into the
+ * generated code. The propagation functions of all other ports are opaque, and are called through a callback into
+ * the simulator. Values are masked to the width of their port, as is done by the FlatNetlist.
+ */
+class NativeNetlist {
+public:
+    using NativeFunction = void (*)(VSRTL_VT_U* values, const void* const* functions, VSRTL_VT_U (*call)(const void*));
+
+    NativeNetlist() = default;
+    NativeNetlist(const NativeNetlist&) = delete;
+    NativeNetlist& operator=(const NativeNetlist&) = delete;
+    ~NativeNetlist() { unload(); }
+
+    /**
+     * @brief generate
+     * Generates the translation unit for @p propagationStack. Ports must have been relocated to slots within
+     * @p values prior to generation.
+     */
+    void generate(const std::vector<PortBase*>& propagationStack, VSRTL_VT_U* values) {
+        unload();
+        m_values = values;
+        m_functions.clear();
+
+        auto operand = [values](const PortBase* p) {
+            return "v[" + std::to_string(p->valueSlot() - values) + "]";
+        };
+
+        std::ostringstream src;
+        src << "// Generated by vsrtl::core::NativeNetlist\n"
+               "#include <cstdint>\n"
+               "#include <stdexcept>\n\n"
+               "namespace {\n"
+               "inline int64_t vsrtl_sext(uint64_t v, unsigned w) {\n"
+               "    return w >= 64 ? static_cast<int64_t>(v) : static_cast<int64_t>(v << (64 - w)) >> (64 - w);\n"
+               "}\n"
+               "[[noreturn]] inline uint64_t vsrtl_out_of_range() {\n"
+               "    throw std::out_of_range(\"vsrtl: value out of range\");\n"
+               "}\n"
+               "}  // namespace\n\n"
+               "extern \"C\" void vsrtl_propagate(uint64_t* v, const void* const* f, "
+               "uint64_t (*call)(const void*)) {\n";
+
+        for (const auto& port : propagationStack) {
+            std::string expr;
+            if (!port->hasPropagationFunction()) {
+                expr = operand(port->getInputPort<PortBase>());
+            } else {
+                if (auto* parent = port->getParent<Component>())
+                    expr = parent->nativeExpression(port, operand);
+                if (expr.empty()) {
+                    expr = "call(f[" + std::to_string(m_functions.size()) + "])";
+                    m_functions.push_back(&port->getPropagationFunction());
+                }
+            }
+            src << "    " << operand(port) << " = " << expr << " & UINT64_C(" << generateBitmask(port->getWidth())
+                << ");\n";
+        }
+        src << "}\n";
+        m_source = src.str();
+    }
+
+    const std::string& source() const { return m_source; }
+
+    /**
+     * @brief compile
+     * Builds and loads the generated translation unit. @p compiler defaults to the CXX environment variable, or "c++"
+     * if unset.
+     * @throws std::runtime_error if compilation or loading fails.
+     */
+    void compile(std::string compiler = {}) {
+        if (m_source.empty())
+            throw std::runtime_error("No native code has been generated");
+        unload();
+#ifdef _WIN32
+        (void)compiler;
+        throw std::runtime_error("Native compilation is not supported on this platform");
+#else
+        if (compiler.empty()) {
+            const char* cxx = std::getenv("CXX");
+            compiler = cxx ? cxx : "c++";
+        }
+
+        namespace fs = std::filesystem;
+        const fs::path base = fs::temp_directory_path() / ("vsrtl_native_" + std::to_string(getpid()) + "_" +
+                                                            std::to_string(reinterpret_cast<uintptr_t>(this)));
+        const fs::path source = base.string() + ".cpp";
+        const fs::path library = base.string() + ".so";
+        const fs::path log = base.string() + ".log";
+        std::ofstream(source) << m_source;
+
+        const std::string cmd = compiler + " -std=c++17 -O2 -shared -fPIC -o \"" + library.string() + "\" \"" +
+                                source.string() + "\" > \"" + log.string() + "\" 2>&1";
+        const int result = std::system(cmd.c_str());
+        std::error_code ec;
+        fs::remove(source, ec);
+        if (result != 0) {
+            std::stringstream errors;
+            errors << std::ifstream(log).rdbuf();
+            fs::remove(log, ec);
+            throw std::runtime_error("Failed to compile native design using '" + compiler + "':\n" + errors.str());
+        }
+        fs::remove(log, ec);
+
+        // The library remains mapped after its file has been removed
+        m_handle = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+        fs::remove(library, ec);
+        if (!m_handle)
+            throw std::runtime_error(std::string("Failed to load native design: ") + dlerror());
+        m_function = reinterpret_cast<NativeFunction>(dlsym(m_handle, "vsrtl_propagate"));
+        if (!m_function) {
+            unload();
+            throw std::runtime_error("Failed to locate propagation function of native design");
+        }
+#endif
+    }
+
+    bool isCompiled() const { return m_function != nullptr; }
+
+    void execute() const { m_function(m_values, m_functions.data(), &callPropagationFunction); }
+
+private:
+    static VSRTL_VT_U callPropagationFunction(const void* function) {
+        return (*static_cast<const PropagationFunction*>(function))();
+    }
+
+    void unload() {
+        m_function = nullptr;
+#ifndef _WIN32
+        if (m_handle)
+            dlclose(m_handle);
+#endif
+        m_handle = nullptr;
+    }
+
+    VSRTL_VT_U* m_values = nullptr;
+    std::string m_source;
+    std::vector<const void*> m_functions;
+    void* m_handle = nullptr;
+    NativeFunction m_function = nullptr;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_NATIVENETLIST_H
@@ -8,11 +8,13 @@
 #include <iostream>
 #include <memory>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "../interface/vsrtl_binutils.h"
 #include "../interface/vsrtl_interface.h"
-
-#include "../graphics/vsrtl_label.h"
+#include "vsrtl_inlinefunction.h"
+#include "vsrtl_profiler.h"
 
 namespace vsrtl {
 namespace core {
@@ -21,6 +23,10 @@ class Component;
 
 enum class PropagationState { unpropagated, propagated, constant };
 
+/// Propagation functions are stored inline within each port. The capacity suffices for lambdas capturing the owning
+/// component and a few scalar values.
+using PropagationFunction = InlineFunction<VSRTL_VT_U(), 3 * sizeof(void*)>;
+
 /**
  * @brief The PortBase class
  * Base class for ports, does not have a bit width property
@@ -59,15 +65,84 @@ public:
         throw std::runtime_error("This is not an enum port!");
     }
 
+    /**
+     * @brief valueSlot
+     * Returns the storage location of the value of this port. Until the owning design has relocated the port into its
+     * contiguous value table, the value is stored within the port itself.
+     */
+    VSRTL_VT_U* valueSlot() const { return m_value; }
+    void relocateValue(VSRTL_VT_U* slot) {
+        *slot = *m_value;
+        m_value = slot;
+    }
+
+    /**
+     * @brief aliasValue
+     * Shares the storage of @p source, whose value this port forwards. Aliased ports are not propagated themselves;
+     * their changed signal is emitted whenever @p source emits its own.
+     */
+    void aliasValue(PortBase* source) {
+        m_value = source->m_value;
+        source->m_aliases.push_back(this);
+    }
+    const std::vector<PortBase*>& aliases() const { return m_aliases; }
+
+    /// The ports which this port drives. Unlike getOutputPorts(), the connections are not copied.
+    const std::vector<SimPort*>& drivenPorts() const { return m_outputPorts; }
+
+    bool hasPropagationFunction() const { return static_cast<bool>(*m_function); }
+    const PropagationFunction& getPropagationFunction() const { return *m_function; }
+
+    /**
+     * @brief relocateFunction
+     * Moves the propagation function of this port to @p slot, such that the owning design may place the functions of
+     * consecutively propagated ports next to each other (see Design::setRelocatePortData()).
+     */
+    void relocateFunction(PropagationFunction* slot) {
+        *slot = std::move(*m_function);
+        m_function = slot;
+    }
+
+    /**
+     * @brief The NotifyPolicy enum
+     * Determines when the changed signal of a port is emitted upon propagation.
+     * onChange: when propagation changes the value of the port.
+     * always:   whenever the port is propagated. Required by views which track state beyond the value of a port.
+     * Policies are resolved by the design during elaboration (see Design::addNotifyRule()).
+     */
+    enum class NotifyPolicy : uint8_t { onChange, always };
+    void setNotifyPolicy(NotifyPolicy policy) { m_notifyPolicy = policy; }
+    NotifyPolicy notifyPolicy() const { return m_notifyPolicy; }
+
+#ifdef VSRTL_PROFILING
+    /// Evaluations of this port through setPortValue() are accumulated into @p counter (see Design::profiler()).
+    void setProfileCounter(ProfileCounter* counter) { m_profile = counter; }
+#endif
+
 protected:
     PropagationState m_propagationState = PropagationState::unpropagated;
+
+    // Port values are initialized to 0xdeadbeef for error detection reasons. In reality (in a circuit), this would
+    // not be the case - the entire circuit is reset when the registers are reset (to 0), and the circuit state is
+    // then propagated.
+    VSRTL_VT_U m_localValue = 0xdeadbeef;
+    VSRTL_VT_U* m_value = &m_localValue;
+
+    PropagationFunction m_propagationFunction = {};
+    /// Location of the propagation function; either m_propagationFunction, or a slot owned by the design.
+    PropagationFunction* m_function = &m_propagationFunction;
+    NotifyPolicy m_notifyPolicy = NotifyPolicy::onChange;
+    std::vector<PortBase*> m_aliases;
+#ifdef VSRTL_PROFILING
+    ProfileCounter* m_profile = nullptr;
+#endif
 };
 
 template <unsigned int W>
 class Port : public PortBase {
 public:
     Port(const std::string& name, SimComponent* parent, PortType type) : PortBase(name, parent, type) {}
-    bool isConnected() const override { return m_inputPort != nullptr || m_propagationFunction; }
+    bool isConnected() const override { return m_inputPort != nullptr || *m_function; }
 
 
     // Port connections are doubly linked
@@ -87,11 +162,11 @@ public:
             *this >> *p;
     }
 
-    VSRTL_VT_U uValue() const override { return m_value & generateBitmask(W); }
-    VSRTL_VT_S sValue() const override { return signextend<W>(m_value); }
+    VSRTL_VT_U uValue() const override { return *m_value & generateBitmask(W); }
+    VSRTL_VT_S sValue() const override { return signextend<W>(*m_value); }
     unsigned int getWidth() const override { return W; }
 
-    explicit operator VSRTL_VT_S() const { return signextend<W>(m_value); }
+    explicit operator VSRTL_VT_S() const { return signextend<W>(*m_value); }
 
     bool isActivePath() const override { return m_activePath; }
 
@@ -108,41 +183,41 @@ public:
 
 
     void setPortValue() override {
-        auto prePropagateValue = m_value;
-        if (m_propagationFunction) {
-            m_value = m_propagationFunction();
-        } else {
-            m_value = getInputPort<Port<W>>()->uValue();
+        auto prePropagateValue = *m_value;
+        {
+            VSRTL_PROFILE(m_profile);
+            if (*m_function) {
+                *m_value = (*m_function)();
+            } else {
+                *m_value = getInputPort<Port<W>>()->uValue();
+            }
         }
-        QString port =QString::fromStdString(getHierName());
-
-        if(port.contains("MIPS")){
+        if (*m_value != prePropagateValue || m_notifyPolicy == NotifyPolicy::always) {
+            // Signal all watcher of this port that the port value changed
             if (getDesign()->signalsEnabled()) {
                 changed.Emit();
+                for (const auto& alias : m_aliases)
+                    alias->changed.Emit();
             }
         }
-        else{
-            if (m_value != prePropagateValue) {
-                // Signal all watcher of this port that the port value changed
-                if (getDesign()->signalsEnabled()) {
-                    changed.Emit();
-                }
-            }
-        }
-
-
-
-
-
     }
 
     void propagate(std::vector<PortBase*>& propagationStack) override {
-        if (m_propagationState == PropagationState::unpropagated) {
-            propagationStack.push_back(this);
-            // Propagate the value to the ports which connect to this
-            for (const auto& port : getOutputPorts<Port<W>>())
-                port->propagate(propagationStack);
-            m_propagationState = PropagationState::propagated;
+        // Propagate the value to the ports which connect to this. Connections from a port form a tree, which is
+        // traversed breadth-first using the propagation stack itself as the work list.
+        if (m_propagationState != PropagationState::unpropagated)
+            return;
+        const size_t first = propagationStack.size();
+        m_propagationState = PropagationState::propagated;
+        propagationStack.push_back(this);
+        for (size_t i = first; i < propagationStack.size(); i++) {
+            for (const auto& out : static_cast<Port<W>*>(propagationStack[i])->m_outputPorts) {
+                auto* port = static_cast<Port<W>*>(out);
+                if (port->m_propagationState != PropagationState::unpropagated)
+                    continue;
+                port->m_propagationState = PropagationState::propagated;
+                propagationStack.push_back(port);
+            }
         }
     }
 
@@ -153,26 +228,20 @@ public:
             port->propagateConstant();
     }
 
-    void operator<<(std::function<VSRTL_VT_U()>&& propagationFunction) {
-        if (m_propagationFunction) {
+    void operator<<(PropagationFunction&& propagationFunction) {
+        if (*m_function) {
             throw std::runtime_error("Propagation function reassignment prohibited");
         }
-        m_propagationFunction = propagationFunction;
+        *m_function = std::move(propagationFunction);
     }
 
     // Value access operators
-    explicit operator VSRTL_VT_U() const { return m_value; }
-    explicit operator bool() const { return m_value & 0b1; }
+    explicit operator VSRTL_VT_U() const { return *m_value; }
+    explicit operator bool() const { return *m_value & 0b1; }
 
 protected:
-    // Port values are initialized to 0xdeadbeef for error detection reasons. In reality (in a circuit), this would
-    // not be the case - the entire circuit is reset when the registers are reset (to 0), and the circuit state is
-    // then propagated.
-    VSRTL_VT_U m_value = 0xdeadbeef;
     bool m_activePath = false;
     bool m_activeFsm = false;
-
-    std::function<VSRTL_VT_U()> m_propagationFunction = {};
 };
 
 template <unsigned int W, typename E_t>
@@ -0,0 +1,97 @@
+#ifndef VSRTL_PORTGRAPH_H
+#define VSRTL_PORTGRAPH_H
+
+#include "../interface/vsrtl_defines.h"
+#include "vsrtl_component.h"
+#include "vsrtl_port.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The PortGraph class
+ * Port-level dependency graph of a design. Nodes are identified by the slot of a port within the value table of the
+ * design. An edge (a -> b) signifies that the value of port b is a function of the value of port a:
+ * - b copies the value of a (a >> b), or
+ * - b is an output port with a propagation function, of a component which has a as an input port or in its
+ *   sensitivity list.
+ * The graph is cut at synchronous components; their outputs are seen as sources of the graph.
+ * Edges are stored in compressed sparse row format.
+ */
+class PortGraph {
+public:
+    struct Range {
+        const uint32_t* first;
+        const uint32_t* last;
+        const uint32_t* begin() const { return first; }
+        const uint32_t* end() const { return last; }
+        size_t size() const { return last - first; }
+    };
+
+    /**
+     * @brief build
+     * Builds the graph for the ports of @p components. All ports must have been relocated into the value table
+     * starting at @p values, which contains @p nSlots slots.
+     */
+    void build(const std::vector<Component*>& components, const VSRTL_VT_U* values, size_t nSlots) {
+        std::vector<std::pair<uint32_t, uint32_t>> edges;
+        auto slotOf = [values](const PortBase* p) { return static_cast<uint32_t>(p->valueSlot() - values); };
+
+        for (const auto& c : components) {
+            c->forEachPort([&](const PortBase* p) {
+                for (const auto& s : p->drivenPorts()) {
+                    const auto* sink = static_cast<const PortBase*>(s);
+                    // Pass-through ports share the slot of the port which they forward
+                    if (!sink->hasPropagationFunction() && slotOf(sink) != slotOf(p))
+                        edges.push_back({slotOf(p), slotOf(sink)});
+                }
+            });
+
+            if (c->isSynchronous())
+                continue;
+
+            for (const auto& out : c->getOutputPorts<PortBase>()) {
+                if (!out->hasPropagationFunction())
+                    continue;
+                for (const auto& in : c->getInputPorts<PortBase>())
+                    edges.push_back({slotOf(in), slotOf(out)});
+                for (const auto& sens : c->getSensitivityList())
+                    edges.push_back({slotOf(sens), slotOf(out)});
+            }
+        }
+
+        m_offsets.assign(nSlots + 1, 0);
+        for (const auto& e : edges)
+            m_offsets[e.first + 1]++;
+        for (size_t i = 0; i < nSlots; i++)
+            m_offsets[i + 1] += m_offsets[i];
+
+        m_readers.resize(edges.size());
+        std::vector<uint32_t> fill(m_offsets.begin(), m_offsets.end() - 1);
+        for (const auto& e : edges)
+            m_readers[fill[e.first]++] = e.second;
+    }
+
+    /**
+     * @brief readers
+     * @returns the slots of all ports which are a function of the port at @p slot.
+     */
+    Range readers(uint32_t slot) const {
+        return {m_readers.data() + m_offsets[slot], m_readers.data() + m_offsets[slot + 1]};
+    }
+
+    size_t nodeCount() const { return m_offsets.empty() ? 0 : m_offsets.size() - 1; }
+
+private:
+    std::vector<uint32_t> m_offsets;
+    std::vector<uint32_t> m_readers;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_PORTGRAPH_H
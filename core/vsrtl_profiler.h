@@ -0,0 +1,223 @@
+#ifndef VSRTL_PROFILER_H
+#define VSRTL_PROFILER_H
+
+#include "../interface/vsrtl_interface.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * Profiling is compiled in by defining VSRTL_PROFILING (see the VSRTL_PROFILING CMake option). The definition must be
+ * consistent across all translation units including the core library, since it alters the layout of ports. When not
+ * defined, VSRTL_PROFILE() expands to nothing, and no profiling state is present within the design.
+ */
+#ifdef VSRTL_PROFILING
+#define VSRTL_PROFILE_CONCAT_(a, b) a##b
+#define VSRTL_PROFILE_CONCAT(a, b) VSRTL_PROFILE_CONCAT_(a, b)
+#define VSRTL_PROFILE(counter) const ::vsrtl::core::ProfileScope VSRTL_PROFILE_CONCAT(_vsrtlProfile, __LINE__)(counter)
+#else
+#define VSRTL_PROFILE(counter)
+#endif
+
+/// The number of times a profiled operation was performed, and the ticks (see ProfileScope::now()) spent doing so.
+struct ProfileCounter {
+    uint64_t count = 0;
+    uint64_t ticks = 0;
+};
+
+/**
+ * @brief The ProfileScope class
+ * Accumulates the ticks spent within its lifetime into a counter. A null counter is not profiled.
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfileCounter* counter) : m_counter(counter), m_start(counter ? now() : 0) {}
+    ~ProfileScope() {
+        if (m_counter) {
+            m_counter->count++;
+            m_counter->ticks += now() - m_start;
+        }
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+    /// The time stamp counter where available, otherwise nanoseconds of the steady clock.
+    static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+#endif
+    }
+
+private:
+    ProfileCounter* m_counter;
+    uint64_t m_start;
+};
+
+/**
+ * @brief The Profiler class
+ * Owns the profile counters of the components of a design (see Design::profiler()). Each component is profiled for
+ * the evaluation of its output ports, the saving of its state when clocked, and its reads and writes of memory.
+ * Memory accesses are performed while evaluating or saving a component, and are as such included in the time of
+ * those. Ticks are converted to time by the ratio of elapsed ticks to elapsed steady clock time since the profiler was
+ * last cleared.
+ */
+class Profiler {
+public:
+    enum class Event { evaluate, save, memoryRead, memoryWrite };
+    static constexpr unsigned s_eventCount = 4;
+
+    struct Row {
+        std::string name;
+        ProfileCounter counters[s_eventCount];
+
+        const ProfileCounter& operator[](Event event) const { return counters[static_cast<unsigned>(event)]; }
+        /// Ticks spent evaluating and saving; memory accesses are included within these.
+        uint64_t ticks() const { return (*this)[Event::evaluate].ticks + (*this)[Event::save].ticks; }
+    };
+
+    Profiler() { clear(); }
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    /// Returns the counter of @p event for @p component. Counters are stable for the lifetime of the profiler.
+    ProfileCounter* counter(const SimComponent* component, Event event) {
+        auto it = m_index.find(component);
+        if (it == m_index.end()) {
+            m_entries.push_back({component, {}});
+            it = m_index.emplace(component, &m_entries.back()).first;
+        }
+        return &it->second->counters[static_cast<unsigned>(event)];
+    }
+
+    /// Zeroes all counters.
+    void clear() {
+        for (auto& entry : m_entries)
+            std::fill(std::begin(entry.counters), std::end(entry.counters), ProfileCounter());
+        m_startTicks = ProfileScope::now();
+        m_startTime = std::chrono::steady_clock::now();
+    }
+
+    /// Profiled components by hierarchical name, in order of decreasing time.
+    std::vector<Row> byInstance() const {
+        std::vector<Row> rows;
+        for (const auto& entry : m_entries) {
+            Row row{entry.component->getHierName(), {}};
+            std::copy(std::begin(entry.counters), std::end(entry.counters), row.counters);
+            rows.push_back(row);
+        }
+        return sorted(std::move(rows));
+    }
+
+    /// Profiled components accumulated by type, in order of decreasing time.
+    std::vector<Row> byType() const {
+        std::map<std::string, Row> types;
+        for (const auto& entry : m_entries) {
+            const std::string type = typeName(*entry.component);
+            Row& row = types.emplace(type, Row{type, {}}).first->second;
+            for (unsigned i = 0; i < s_eventCount; i++) {
+                row.counters[i].count += entry.counters[i].count;
+                row.counters[i].ticks += entry.counters[i].ticks;
+            }
+        }
+        std::vector<Row> rows;
+        for (auto& type : types)
+            rows.push_back(std::move(type.second));
+        return sorted(std::move(rows));
+    }
+
+    /// Nanoseconds per tick, measured since the profiler was last cleared.
+    double nanosecondsPerTick() const {
+        const uint64_t ticks = ProfileScope::now() - m_startTicks;
+        const auto elapsed = std::chrono::steady_clock::now() - m_startTime;
+        return ticks == 0 ? 1.0 : std::chrono::duration<double, std::nano>(elapsed).count() / ticks;
+    }
+
+    /// Writes the profile by type and by instance to @p os.
+    void report(std::ostream& os) const {
+        const double nsPerTick = nanosecondsPerTick();
+        os << "Profile by type:\n";
+        writeTable(os, byType(), nsPerTick);
+        os << "\nProfile by instance:\n";
+        writeTable(os, byInstance(), nsPerTick);
+    }
+
+private:
+    struct Entry {
+        const SimComponent* component;
+        ProfileCounter counters[s_eventCount];
+    };
+
+    static std::vector<Row> sorted(std::vector<Row> rows) {
+        std::stable_sort(rows.begin(), rows.end(), [](const Row& lhs, const Row& rhs) {
+            return lhs.ticks() > rhs.ticks() || (lhs.ticks() == rhs.ticks() && lhs.name < rhs.name);
+        });
+        return rows;
+    }
+
+    static std::string typeName(const SimComponent& component) {
+        const char* name = typeid(component).name();
+#if defined(__GNUG__)
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+        if (status == 0 && demangled) {
+            std::string result = demangled;
+            std::free(demangled);
+            return result;
+        }
+#endif
+        return name;
+    }
+
+    static void writeTable(std::ostream& os, const std::vector<Row>& rows, double nsPerTick) {
+        uint64_t total = 0;
+        for (const auto& row : rows)
+            total += row.ticks();
+        char line[128];
+        std::snprintf(line, sizeof(line), "%12s %6s %12s %12s %12s %12s  %s\n", "time [us]", "%", "evaluations",
+                      "saves", "reads", "writes", "name");
+        os << line;
+        for (const auto& row : rows) {
+            std::snprintf(line, sizeof(line), "%12.1f %6.2f %12llu %12llu %12llu %12llu  ",
+                          row.ticks() * nsPerTick / 1e3, total == 0 ? 0.0 : 100.0 * row.ticks() / total,
+                          static_cast<unsigned long long>(row[Event::evaluate].count),
+                          static_cast<unsigned long long>(row[Event::save].count),
+                          static_cast<unsigned long long>(row[Event::memoryRead].count),
+                          static_cast<unsigned long long>(row[Event::memoryWrite].count));
+            os << line << row.name << "\n";
+        }
+    }
+
+    std::deque<Entry> m_entries;
+    std::unordered_map<const SimComponent*, Entry*> m_index;
+    uint64_t m_startTicks = 0;
+    std::chrono::steady_clock::time_point m_startTime;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_PROFILER_H
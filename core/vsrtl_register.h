@@ -4,9 +4,10 @@
 #include "../interface/vsrtl_binutils.h"
 #include "vsrtl_component.h"
 #include "vsrtl_port.h"
+#include "vsrtl_reversejournal.h"
 
 #include <algorithm>
-#include <deque>
+#include <typeinfo>
 #include <vector>
 
 /** Registered input
@@ -78,11 +79,53 @@ public:
     /**
      * @brief reverseStackSizeChanged
      * Whenever the reverse stack changes, all synchronous elements may check whether they need to delete cycles within
-     * their current reverse stack.
+     * their current reverse stack. Components which record their state in the reverse journal of the design need not
+     * do so.
      */
-    virtual void reverseStackSizeChanged() = 0;
+    virtual void reverseStackSizeChanged() {}
+
+    /**
+     * @brief attachJournal
+     * Called by the owning design during initialization. State overwritten when the component is clocked is recorded
+     * to @p journal (see journal()), identified by @p owner.
+     */
+    void attachJournal(ReverseJournal* journal, uint32_t owner) {
+        m_journal = journal;
+        m_journalOwner = owner;
+    }
+
+    /**
+     * @brief undo
+     * Restores the state described by @p entry, as recorded through journal(). Called by the design when reversing
+     * a cycle, for each entry of the cycle in reverse order of recording.
+     */
+    virtual void undo(const ReverseJournal::Entry& /* entry */) {}
+
+    /**
+     * @brief stateSize/saveState/restoreState
+     * Appends the stateSize() words of state held by the component to @p state, respectively restores the component
+     * from words previously appended by saveState(). Used for design snapshots (see Design::snapshot()). State held in
+     * address spaces is not part of the state of a component.
+     */
+    virtual size_t stateSize() const { return 0; }
+    virtual void saveState(std::vector<VSRTL_VT_U>& /* state */) const {}
+    virtual void restoreState(const VSRTL_VT_U* /* state */) {}
+
+protected:
+    /**
+     * @brief journal
+     * Records that the state of this component at @p key held @p value prior to the current cycle. Components
+     * recording their state this way are reversed through undo(), and need not keep reverse stacks of their own.
+     */
+    void journal(VSRTL_VT_U value, VSRTL_VT_U key = 0, uint32_t tag = 0) {
+        if (m_journal)
+            m_journal->record({m_journalOwner, tag, key, value});
+    }
 
 private:
+    ReverseJournal* m_journal = nullptr;
+    uint32_t m_journalOwner = 0;
+
     struct ReverseStackCounter {
         unsigned max = 100;    // Maximum number of cycles on clocked components reverse stacks
         unsigned current = 0;  // Current number of reversible cycles
@@ -99,6 +142,32 @@ public:
 
     virtual PortBase* getIn() = 0;
     virtual PortBase* getOut() = 0;
+
+    /**
+     * @brief getEnable/getClear
+     * Synchronous enable and clear inputs of the register, if any. When clocked, a register with an enable input only
+     * updates its value when enabled, in which case the value is cleared if the clear input is set.
+     */
+    virtual PortBase* getEnable() { return nullptr; }
+    virtual PortBase* getClear() { return nullptr; }
+
+    /**
+     * @brief depth
+     * Number of values held by the register. Registers with a depth of 1 output the value loaded from their input in
+     * the previous cycle.
+     */
+    virtual unsigned depth() { return 1; }
+    virtual VSRTL_VT_U getInitValue() const { return 0; }
+
+    /**
+     * @brief bankable/relocateState
+     * Registers whose save() merely latches the value of their input (subject to getEnable() and getClear(), if
+     * present) may have their state relocated to @p slot within the register bank of the owning design (see
+     * RegisterBank), which then commits them in bulk instead of calling save(). The current value of the register is
+     * moved to @p slot.
+     */
+    virtual bool bankable() const { return false; }
+    virtual void relocateState(VSRTL_VT_U* /* slot */) {}
 };
 
 template <unsigned int W>
@@ -108,32 +177,36 @@ public:
 
     Register(const std::string& name, SimComponent* parent) : RegisterBase(name, parent) {
         // Calling out.propagate() will clock the register the register
-        out << ([=] { return m_savedValue; });
+        out << ([=] { return *m_state; });
     }
 
     void setInitValue(VSRTL_VT_U value) { m_initvalue = value; }
+    VSRTL_VT_U getInitValue() const override { return m_initvalue; }
 
-    void reset() override {
-        m_savedValue = m_initvalue;
-        m_reverseStack.clear();
-    }
+    void reset() override { *m_state = m_initvalue; }
 
-    void save() override {
-        saveToStack();
-        m_savedValue = in.uValue();
-    }
+    void save() override { update(in.uValue()); }
 
     void forceValue(VSRTL_VT_U /* addr */, VSRTL_VT_U value) override {
-        // Sign-extension with unsigned type forces width truncation to m_width bits
-        m_savedValue = signextend<W>(value);
-        // Forced values are a modification of the current state and thus not pushed onto the reverse stack
+        // Forced values are a modification of the state of the current cycle; reversing the cycle restores the value
+        // which the register held prior to it. Sign-extension with unsigned type forces width truncation to m_width
+        // bits.
+        update(signextend<W>(value));
     }
 
-    void reverse() override {
-        if (m_reverseStack.size() > 0) {
-            m_savedValue = m_reverseStack.front();
-            m_reverseStack.pop_front();
-        }
+    // The state of the register is reversed through the reverse journal of the design
+    void reverse() override {}
+    void undo(const ReverseJournal::Entry& entry) override { *m_state = entry.value; }
+
+    size_t stateSize() const override { return 1; }
+    void saveState(std::vector<VSRTL_VT_U>& state) const override { state.push_back(*m_state); }
+    void restoreState(const VSRTL_VT_U* state) override { *m_state = state[0]; }
+
+    // Only plain registers are bankable; derived registers may clock their state differently
+    bool bankable() const override { return typeid(*this) == typeid(Register<W>); }
+    void relocateState(VSRTL_VT_U* slot) override {
+        *slot = *m_state;
+        m_state = slot;
     }
 
     PortBase* getIn() override { return &in; }
@@ -142,23 +215,19 @@ public:
     INPUTPORT(in, W);
     OUTPUTPORT(out, W);
 
-    void reverseStackSizeChanged() override {
-        if (reverseStackSize() < m_reverseStack.size()) {
-            m_reverseStack.resize(m_reverseStack.size());
-        }
-    }
-
 protected:
-    void saveToStack() {
-        m_reverseStack.push_front(m_savedValue);
-        if (m_reverseStack.size() > reverseStackSize()) {
-            m_reverseStack.pop_back();
-        }
+    /// Sets the value of the register, journaling the previous value if it changes.
+    void update(VSRTL_VT_U value) {
+        if (value == *m_state)
+            return;
+        this->journal(*m_state);
+        *m_state = value;
     }
 
     VSRTL_VT_U m_savedValue = 0;
+    /// Location of the state of the register; either m_savedValue, or a slot within the register bank of the design.
+    VSRTL_VT_U* m_state = &m_savedValue;
     VSRTL_VT_U m_initvalue = 0;
-    std::deque<VSRTL_VT_U> m_reverseStack;
 };
 
 // Synchronous clear/enable register
@@ -168,16 +237,16 @@ public:
     RegisterClEn(const std::string& name, SimComponent* parent) : Register<W>(name, parent) {}
 
     void save() override {
-        this->saveToStack();
         if (enable.uValue()) {
-            if (clear.uValue()) {
-                this->m_savedValue = 0;
-            } else {
-                this->m_savedValue = this->in.uValue();
-            }
+            this->update(clear.uValue() ? 0 : this->in.uValue());
         }
     }
 
+    PortBase* getEnable() override { return &enable; }
+    PortBase* getClear() override { return &clear; }
+
+    bool bankable() const override { return typeid(*this) == typeid(RegisterClEn<W>); }
+
     INPUTPORT(enable, 1);
     INPUTPORT(clear, 1);
 };
@@ -199,37 +268,51 @@ public:
     }
 
     void setInitValue(VSRTL_VT_U value) { m_initvalue = value; }
+    VSRTL_VT_U getInitValue() const override { return m_initvalue; }
+    unsigned depth() override { return stages.getValue(); }
 
     void reset() override {
         for (unsigned i = 0; i < m_savedValues.size(); i++) {
             m_savedValues[i] = m_initvalue;
         }
-        m_reverseStack.clear();
     }
 
     void save() override {
-        m_reverseStack.push_front(m_savedValues.at(stages.getValue() - 1));
-        if (m_reverseStack.size() > reverseStackSize()) {
-            m_reverseStack.pop_back();
-        }
+        const VSRTL_VT_U value = in.uValue();
+        // Shifting a value into stages which all hold that value leaves the shift register unchanged
+        if (std::all_of(m_savedValues.begin(), m_savedValues.end(), [value](VSRTL_VT_U v) { return v == value; }))
+            return;
+        journal(m_savedValues.at(stages.getValue() - 1), 0, Shifted);
         // Rotate to the right and store new value as first register
         std::rotate(m_savedValues.rbegin(), m_savedValues.rbegin() + 1, m_savedValues.rend());
-        m_savedValues.at(0) = in.uValue();
+        m_savedValues.at(0) = value;
     }
 
     void forceValue(VSRTL_VT_U /* addr */, VSRTL_VT_U value) override {
+        // Forced values are a modification of the state of the current cycle, and are undone when reversing it.
         // Sign-extension with unsigned type forces width truncation to m_width bits
-        m_savedValues[0] = signextend<VSRTL_VT_U, W>(value);
-        // Forced values are a modification of the current state and thus not pushed onto the reverse stack
+        journal(m_savedValues[0], 0, Forced);
+        m_savedValues[0] = signextend<W>(value);
     }
 
-    void reverse() override {
-        if (m_reverseStack.size() > 0) {
-            // Rotate to the left and store popped value as last register
-            std::rotate(m_savedValues.begin(), m_savedValues.begin() + 1, m_savedValues.end());
-            m_savedValues.at(stages.getValue() - 1) = m_reverseStack.front();
-            m_reverseStack.pop_front();
+    // The state of the shift register is reversed through the reverse journal of the design
+    void reverse() override {}
+    void undo(const ReverseJournal::Entry& entry) override {
+        if (entry.tag == Forced) {
+            m_savedValues[0] = entry.value;
+            return;
         }
+        // Rotate to the left and store the shifted-out value as last register
+        std::rotate(m_savedValues.begin(), m_savedValues.begin() + 1, m_savedValues.end());
+        m_savedValues.at(stages.getValue() - 1) = entry.value;
+    }
+
+    size_t stateSize() const override { return m_savedValues.size(); }
+    void saveState(std::vector<VSRTL_VT_U>& state) const override {
+        state.insert(state.end(), m_savedValues.begin(), m_savedValues.end());
+    }
+    void restoreState(const VSRTL_VT_U* state) override {
+        std::copy(state, state + m_savedValues.size(), m_savedValues.begin());
     }
 
     PortBase* getIn() override { return &in; }
@@ -239,18 +322,14 @@ public:
     OUTPUTPORT(out, W);
     PARAMETER(stages, int, 2);
 
-    void reverseStackSizeChanged() override {
-        if (reverseStackSize() < m_reverseStack.size()) {
-            m_reverseStack.resize(m_reverseStack.size());
-        }
-    }
-
 protected:
+    /// Kinds of journal entries recorded by the shift register
+    enum JournalTag : uint32_t { Shifted, Forced };
+
     void stagesChanged() { m_savedValues.resize(stages.getValue()); }
 
     std::vector<VSRTL_VT_U> m_savedValues;
     VSRTL_VT_U m_initvalue = 0;
-    std::deque<VSRTL_VT_U> m_reverseStack;
 };
 
 }  // namespace core
@@ -0,0 +1,152 @@
+#ifndef VSRTL_REGISTERBANK_H
+#define VSRTL_REGISTERBANK_H
+
+#include "../interface/vsrtl_defines.h"
+#include "vsrtl_reversejournal.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The RegisterBank class
+ * Contiguous storage for the state of registers which merely latch their input when clocked, optionally gated by a
+ * synchronous enable and clear input (see RegisterBase::bankable()). The state of each such register is relocated into
+ * the bank, and the value table slots of its inputs are recorded in the same order, such that the registers are
+ * committed in bulk. Plain registers are committed through a tight gather of all inputs, followed by a copy into the
+ * state array. Enabled registers whose enable input is low are skipped entirely.
+ * Only registers whose value changes are journaled, and reported through changedOutputs().
+ */
+class RegisterBank {
+public:
+    static constexpr uint32_t s_none = UINT32_MAX;
+
+    /**
+     * @brief allocate
+     * Sizes the bank for @p plain registers without, and @p enabled registers with an enable input. Must be called
+     * prior to add(), and not again while any register state resides in the bank.
+     */
+    void allocate(size_t plain, size_t enabled) {
+        m_state.assign(plain + enabled, 0);
+        m_next.assign(plain, 0);
+        m_plain = {};
+        m_enabled = {};
+        m_plain.reserve(plain);
+        m_enabled.reserve(enabled);
+        m_enables.clear();
+        m_clears.clear();
+        m_enables.reserve(enabled);
+        m_clears.reserve(enabled);
+        m_changedOutputs.clear();
+    }
+
+    /**
+     * @brief add
+     * Adds a register latching the value table slot @p input, masked to @p mask, and identified in the reverse journal
+     * by @p owner. @p output is the value table slot of the output of the register, as reported by changedOutputs().
+     * If @p enable is not s_none, the register only latches its input while the value table slot @p enable is set, in
+     * which case it is cleared instead if the slot @p clear (if not s_none) is set.
+     * @returns the location of the state of the register within the bank.
+     */
+    VSRTL_VT_U* add(uint32_t input, uint32_t output, VSRTL_VT_U mask, uint32_t owner, uint32_t enable = s_none,
+                    uint32_t clear = s_none) {
+        if (enable == s_none) {
+            m_plain.push_back(input, output, mask, owner);
+            return &m_state[m_plain.size() - 1];
+        }
+        m_enabled.push_back(input, output, mask, owner);
+        m_enables.push_back(enable);
+        m_clears.push_back(clear);
+        return &m_state[m_next.size() + m_enabled.size() - 1];
+    }
+
+    /**
+     * @brief commit
+     * Latches the inputs of all registers from the value table @p values, recording the previous value of each
+     * register which changes to @p journal.
+     */
+    void commit(const VSRTL_VT_U* values, ReverseJournal& journal) {
+        m_changedOutputs.clear();
+        const bool recording = journal.recording();
+
+        // Plain registers: gather all inputs, then detect changes, and commit through a single copy
+        const size_t n = m_plain.size();
+        VSRTL_VT_U* const next = m_next.data();
+        VSRTL_VT_U* const state = m_state.data();
+        const uint32_t* const inputs = m_plain.inputs.data();
+        const VSRTL_VT_U* const masks = m_plain.masks.data();
+        for (size_t i = 0; i < n; i++)
+            next[i] = values[inputs[i]] & masks[i];
+        for (size_t i = 0; i < n; i++) {
+            if (next[i] != state[i]) {
+                if (recording)
+                    journal.record({m_plain.owners[i], 0, 0, state[i]});
+                m_changedOutputs.push_back(m_plain.outputs[i]);
+            }
+        }
+        std::copy(next, next + n, state);
+
+        // Enabled registers: registers which are not enabled are left untouched
+        VSRTL_VT_U* const enabledState = state + n;
+        for (size_t i = 0; i < m_enabled.size(); i++) {
+            if ((values[m_enables[i]] & 0b1) == 0)
+                continue;
+            const bool clear = m_clears[i] != s_none && (values[m_clears[i]] & 0b1);
+            const VSRTL_VT_U value = clear ? 0 : values[m_enabled.inputs[i]] & m_enabled.masks[i];
+            if (value == enabledState[i])
+                continue;
+            if (recording)
+                journal.record({m_enabled.owners[i], 0, 0, enabledState[i]});
+            m_changedOutputs.push_back(m_enabled.outputs[i]);
+            enabledState[i] = value;
+        }
+    }
+
+    /// Value table slots of the outputs of the registers which changed value in the last commit().
+    const std::vector<uint32_t>& changedOutputs() const { return m_changedOutputs; }
+
+    size_t size() const { return m_plain.size() + m_enabled.size(); }
+    size_t enabledCount() const { return m_enabled.size(); }
+
+private:
+    struct Registers {
+        std::vector<uint32_t> inputs;
+        std::vector<uint32_t> outputs;
+        std::vector<VSRTL_VT_U> masks;
+        /// Index of each register amongst the clocked components of the design.
+        std::vector<uint32_t> owners;
+
+        size_t size() const { return inputs.size(); }
+        void reserve(size_t n) {
+            inputs.reserve(n);
+            outputs.reserve(n);
+            masks.reserve(n);
+            owners.reserve(n);
+        }
+        void push_back(uint32_t input, uint32_t output, VSRTL_VT_U mask, uint32_t owner) {
+            inputs.push_back(input);
+            outputs.push_back(output);
+            masks.push_back(mask);
+            owners.push_back(owner);
+        }
+    };
+
+    /// State of each register; plain registers first, followed by enabled registers.
+    std::vector<VSRTL_VT_U> m_state;
+    /// Latched input values of plain registers, prior to being committed.
+    std::vector<VSRTL_VT_U> m_next;
+    Registers m_plain;
+    Registers m_enabled;
+    /// Value table slots of the enable and clear inputs of each enabled register.
+    std::vector<uint32_t> m_enables;
+    std::vector<uint32_t> m_clears;
+    std::vector<uint32_t> m_changedOutputs;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_REGISTERBANK_H
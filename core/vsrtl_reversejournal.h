@@ -0,0 +1,144 @@
+#ifndef VSRTL_REVERSEJOURNAL_H
+#define VSRTL_REVERSEJOURNAL_H
+
+#include "../interface/vsrtl_defines.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The ReverseJournal class
+ * Design-level record of the state overwritten by clocking a design, used to reverse it. For each clocked cycle, the
+ * journal holds a list of entries, each describing a piece of state (as identified by its owner) and the value which
+ * it held prior to the cycle. Only state which changes is recorded, such that the memory used by the journal is
+ * proportional to the activity of the design rather than to the number of its clocked components.
+ * Entries and cycles are stored in contiguous ring buffers. Once more than depth() cycles have been recorded, the
+ * entries of the oldest cycle are discarded.
+ */
+class ReverseJournal {
+public:
+    struct Entry {
+        /// Index of the clocked component which recorded the entry.
+        uint32_t owner;
+        /// Owner-specific auxiliary data, ie. the width of a memory access.
+        uint32_t tag;
+        /// Owner-specific location of the state, ie. a memory address.
+        VSRTL_VT_U key;
+        /// Value of the state prior to the cycle.
+        VSRTL_VT_U value;
+    };
+
+    void setDepth(unsigned depth) {
+        m_depth = depth;
+        while (m_cycles.size() > m_depth)
+            dropOldestCycle();
+    }
+    unsigned depth() const { return m_depth; }
+
+    /**
+     * @brief beginCycle
+     * Opens a new cycle, to which subsequent entries are recorded.
+     */
+    void beginCycle() {
+        if (m_depth == 0)
+            return;
+        if (m_cycles.size() == m_depth)
+            dropOldestCycle();
+        m_cycles.push_back(0);
+    }
+
+    /// True if entries are recorded, ie. if a cycle has been opened and the depth of the journal is nonzero.
+    bool recording() const { return m_cycles.size() != 0; }
+
+    void record(const Entry& entry) {
+        if (m_cycles.size() == 0)
+            return;
+        m_entries.push_back(entry);
+        m_cycles.back()++;
+    }
+
+    /**
+     * @brief reverseCycle
+     * Calls @p undo with each entry of the most recent cycle, in reverse order of recording, and discards the cycle.
+     * @returns false if no cycle has been recorded.
+     */
+    template <typename F>
+    bool reverseCycle(F&& undo) {
+        if (m_cycles.size() == 0)
+            return false;
+        for (uint32_t n = m_cycles.back(); n > 0; n--) {
+            undo(m_entries.back());
+            m_entries.pop_back();
+        }
+        m_cycles.pop_back();
+        return true;
+    }
+
+    void clear() {
+        m_entries.clear();
+        m_cycles.clear();
+    }
+
+    size_t cycleCount() const { return m_cycles.size(); }
+    size_t entryCount() const { return m_entries.size(); }
+
+private:
+    /// Growable ring buffer, such that cycles may be discarded from the front and reversed from the back.
+    template <typename T>
+    class Ring {
+    public:
+        size_t size() const { return m_size; }
+        T& back() { return m_data[(m_head + m_size - 1) & (m_data.size() - 1)]; }
+        T& front() { return m_data[m_head]; }
+        void push_back(const T& v) {
+            if (m_size == m_data.size())
+                grow();
+            m_data[(m_head + m_size) & (m_data.size() - 1)] = v;
+            m_size++;
+        }
+        void pop_back() { m_size--; }
+        void pop_front(size_t n = 1) {
+            if (n == 0)
+                return;
+            m_head = (m_head + n) & (m_data.size() - 1);
+            m_size -= n;
+        }
+        void clear() {
+            m_head = 0;
+            m_size = 0;
+        }
+
+    private:
+        void grow() {
+            // Capacity is kept at a power of two, such that indices wrap through masking
+            std::vector<T> data(m_data.empty() ? 16 : m_data.size() * 2);
+            for (size_t i = 0; i < m_size; i++)
+                data[i] = m_data[(m_head + i) & (m_data.size() - 1)];
+            m_data = std::move(data);
+            m_head = 0;
+        }
+
+        std::vector<T> m_data;
+        size_t m_head = 0;
+        size_t m_size = 0;
+    };
+
+    void dropOldestCycle() {
+        m_entries.pop_front(m_cycles.front());
+        m_cycles.pop_front();
+    }
+
+    unsigned m_depth = 100;
+    Ring<Entry> m_entries;
+    /// Number of entries recorded in each cycle, oldest first.
+    Ring<uint32_t> m_cycles;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_REVERSEJOURNAL_H
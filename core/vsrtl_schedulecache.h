@@ -0,0 +1,249 @@
+#ifndef VSRTL_SCHEDULECACHE_H
+#define VSRTL_SCHEDULECACHE_H
+
+#include "../interface/vsrtl_parameter.h"
+#include "vsrtl_component.h"
+#include "vsrtl_port.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The ScheduleCache class
+ * Stores the propagation schedule of an elaborated design on disk, keyed by a structural hash of the design. The hash
+ * covers the hierarchy, the type and name of each component, its parameters, and the width, connections, notify policy
+ * and propagation function of each of its ports. Components and ports are identified by their index in hierarchical
+ * pre-order (see Component::forEachPort()), and so a cached schedule may be restored by any process constructing the
+ * same design.
+ * The cache is best-effort; files which cannot be read, or which do not match the hash of the design, are ignored.
+ */
+class ScheduleCache {
+public:
+    /// The schedule of a design, in terms of component and port indices.
+    struct Schedule {
+        std::vector<uint32_t> propagationStack;
+        std::vector<uint32_t> unobservedPorts;
+        std::vector<std::pair<uint32_t, uint32_t>> passThroughPorts;
+        std::vector<uint32_t> clockedComponents;
+        std::vector<uint32_t> registers;
+    };
+
+    explicit ScheduleCache(const std::vector<Component*>& components) : m_components(components) {
+        size_t nPorts = 0;
+        for (const auto& c : components)
+            nPorts += c->portCount();
+        m_ports.reserve(nPorts);
+        m_portIndex.reserve(nPorts);
+        for (const auto& c : components) {
+            c->forEachPort([this](PortBase* p) {
+                m_portIndex.emplace(p, static_cast<uint32_t>(m_ports.size()));
+                m_ports.push_back(p);
+            });
+        }
+    }
+
+    uint32_t indexOf(const PortBase* p) const {
+        auto it = m_portIndex.find(p);
+        return it == m_portIndex.end() ? s_none : it->second;
+    }
+    PortBase* portAt(uint32_t index) const { return m_ports.at(index); }
+    size_t portCount() const { return m_ports.size(); }
+
+    /**
+     * @brief structuralHash
+     * @returns the hash of the structure of the design, combined with @p seed. Options of the design which affect
+     * its schedule should be hashed into @p seed.
+     */
+    uint64_t structuralHash(uint64_t seed = s_fnvOffset) const {
+        uint64_t h = seed;
+        std::unordered_map<const SimComponent*, uint32_t> componentIndex;
+        componentIndex.reserve(m_components.size());
+        for (uint32_t i = 0; i < m_components.size(); i++)
+            componentIndex.emplace(m_components[i], i);
+
+        for (const auto& c : m_components) {
+            auto parent = componentIndex.find(c->getParent<SimComponent>());
+            h = hash(h, parent == componentIndex.end() ? s_none : parent->second);
+            h = hash(h, typeid(*c).name());
+            h = hash(h, c->getName());
+            h = hash(h, static_cast<uint64_t>(c->isStateful()));
+            for (const auto& sens : c->getSensitivityList())
+                h = hash(h, indexOf(sens));
+            // Parameters are ordered by address, which differs between processes
+            auto params = c->getParameters();
+            std::sort(params.begin(), params.end(),
+                      [](const ParameterBase* a, const ParameterBase* b) { return a->getName() < b->getName(); });
+            for (const auto& param : params)
+                h = hashParameter(h, param);
+            c->forEachPort([&](PortBase* p) {
+                h = hash(h, p->getName());
+                h = hash(h, p->getWidth());
+                h = hash(h, static_cast<uint64_t>(p->type()));
+                h = hash(h, static_cast<uint64_t>(p->hasPropagationFunction()));
+                h = hash(h, static_cast<uint64_t>(p->notifyPolicy()));
+                h = hash(h, indexOf(static_cast<const PortBase*>(p->getInputPort())));
+            });
+        }
+        return h;
+    }
+
+    static uint64_t hash(uint64_t h, uint64_t value) {
+        for (unsigned i = 0; i < sizeof(value); i++) {
+            h ^= (value >> (i * 8)) & 0xFF;
+            h *= s_fnvPrime;
+        }
+        return h;
+    }
+
+    static uint64_t hash(uint64_t h, const std::string& value) {
+        h = hash(h, static_cast<uint64_t>(value.size()));
+        for (const auto& ch : value) {
+            h ^= static_cast<unsigned char>(ch);
+            h *= s_fnvPrime;
+        }
+        return h;
+    }
+
+    /**
+     * @brief read
+     * Reads the schedule stored in @p path into @p schedule.
+     * @returns false if the file does not exist, is malformed, or does not hold a schedule for a design of hash
+     * @p designHash.
+     */
+    bool read(const std::string& path, uint64_t designHash, Schedule& schedule) const {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return false;
+
+        uint32_t magic = 0, version = 0;
+        uint64_t fileHash = 0;
+        if (!readValue(file, magic) || !readValue(file, version) || !readValue(file, fileHash) ||
+            magic != s_magic || version != s_version || fileHash != designHash)
+            return false;
+
+        const uint32_t nComponents = static_cast<uint32_t>(m_components.size());
+        const uint32_t nPorts = static_cast<uint32_t>(m_ports.size());
+        std::vector<uint32_t> passThrough;
+        if (!readIndices(file, schedule.propagationStack, nPorts) ||
+            !readIndices(file, schedule.unobservedPorts, nPorts) || !readIndices(file, passThrough, nPorts) ||
+            !readIndices(file, schedule.clockedComponents, nComponents) ||
+            !readIndices(file, schedule.registers, nComponents) || passThrough.size() % 2 != 0)
+            return false;
+
+        schedule.passThroughPorts.clear();
+        for (size_t i = 0; i < passThrough.size(); i += 2)
+            schedule.passThroughPorts.push_back({passThrough[i], passThrough[i + 1]});
+        return true;
+    }
+
+    /**
+     * @brief write
+     * Writes @p schedule to @p path. The file is written under a temporary name and then renamed, such that
+     * concurrent processes never observe a partially written schedule.
+     * @returns whether the schedule was written.
+     */
+    static bool write(const std::string& path, uint64_t designHash, const Schedule& schedule) {
+        const std::string tmpPath = path + "." + std::to_string(std::random_device()()) + ".tmp";
+        {
+            std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!file)
+                return false;
+
+            std::vector<uint32_t> passThrough;
+            for (const auto& alias : schedule.passThroughPorts) {
+                passThrough.push_back(alias.first);
+                passThrough.push_back(alias.second);
+            }
+            writeValue(file, s_magic);
+            writeValue(file, s_version);
+            writeValue(file, designHash);
+            const std::vector<uint32_t>* sections[] = {&schedule.propagationStack, &schedule.unobservedPorts,
+                                                       &passThrough, &schedule.clockedComponents, &schedule.registers};
+            for (const auto* indices : sections) {
+                writeValue(file, static_cast<uint32_t>(indices->size()));
+                file.write(reinterpret_cast<const char*>(indices->data()), indices->size() * sizeof(uint32_t));
+            }
+            if (!file) {
+                file.close();
+                std::remove(tmpPath.c_str());
+                return false;
+            }
+        }
+        if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    static constexpr uint32_t s_none = UINT32_MAX;
+
+private:
+    static uint64_t hashParameter(uint64_t h, ParameterBase* param) {
+        h = hash(h, param->getName());
+        if (auto* p = dynamic_cast<Parameter<int>*>(param)) {
+            h = hash(h, static_cast<uint64_t>(p->getValue()));
+        } else if (auto* p = dynamic_cast<Parameter<bool>*>(param)) {
+            h = hash(h, static_cast<uint64_t>(p->getValue()));
+        } else if (auto* p = dynamic_cast<Parameter<std::string>*>(param)) {
+            h = hash(h, p->getValue());
+        } else if (auto* p = dynamic_cast<Parameter<std::vector<int>>*>(param)) {
+            for (const auto& v : p->getValue())
+                h = hash(h, static_cast<uint64_t>(v));
+        } else if (auto* p = dynamic_cast<Parameter<std::vector<std::string>>*>(param)) {
+            for (const auto& v : p->getValue())
+                h = hash(h, v);
+        }
+        return h;
+    }
+
+    template <typename T>
+    static bool readValue(std::istream& is, T& value) {
+        return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    template <typename T>
+    static void writeValue(std::ostream& os, const T& value) {
+        os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    /// Reads a length-prefixed array of indices, each of which must be less than @p bound.
+    static bool readIndices(std::istream& is, std::vector<uint32_t>& indices, uint32_t bound) {
+        uint32_t size = 0;
+        if (!readValue(is, size) || size > bound * 2)
+            return false;
+        indices.resize(size);
+        if (!is.read(reinterpret_cast<char*>(indices.data()), size * sizeof(uint32_t)))
+            return false;
+        for (const auto& index : indices) {
+            if (index >= bound)
+                return false;
+        }
+        return true;
+    }
+
+    static constexpr uint32_t s_magic = 0x48435356;  // "VSCH"
+    static constexpr uint32_t s_version = 1;
+    static constexpr uint64_t s_fnvOffset = 0xcbf29ce484222325ULL;
+    static constexpr uint64_t s_fnvPrime = 0x100000001b3ULL;
+
+    const std::vector<Component*>& m_components;
+    std::vector<PortBase*> m_ports;
+    std::unordered_map<const PortBase*, uint32_t> m_portIndex;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_SCHEDULECACHE_H
@@ -11,7 +11,8 @@ enum class ShiftType { sl, sra, srl };
 template <unsigned int W>
 class Shift : public Component {
 public:
-    Shift(const std::string& name, SimComponent* parent, ShiftType t, unsigned int shamt) : Component(name, parent) {
+    Shift(const std::string& name, SimComponent* parent, ShiftType t, unsigned int shamt)
+        : Component(name, parent), m_type(t), m_shamt(shamt) {
         out << [=] {
             if (t == ShiftType::sl) {
                 return in.uValue() << shamt;
@@ -25,8 +26,37 @@ public:
         };
     }
 
+    std::string nativeExpression(const PortBase*, const NativeOperand& operand) const override {
+        if (m_shamt >= VSRTL_VT_BITS)
+            return {};  // Shift exceeds the value type; defer to the propagation function
+        const std::string shamt = std::to_string(m_shamt);
+        switch (m_type) {
+            case ShiftType::sl:
+                return "(" + operand(&in) + " << " + shamt + ")";
+            case ShiftType::sra:
+                return "static_cast<uint64_t>(vsrtl_sext(" + operand(&in) + ", " + std::to_string(W) + ") >> " +
+                       shamt + ")";
+            case ShiftType::srl:
+                return "(" + operand(&in) + " >> " + shamt + ")";
+        }
+        return {};
+    }
+
+    BatchPrimitive batchPrimitive(const PortBase*) const override {
+        if (m_shamt >= VSRTL_VT_BITS)
+            return {};
+        const auto op = m_type == ShiftType::sl    ? BatchPrimitive::Op::shl
+                        : m_type == ShiftType::sra ? BatchPrimitive::Op::sra
+                                                   : BatchPrimitive::Op::shr;
+        return {op, {&in}, m_shamt};
+    }
+
     OUTPUTPORT(out, W);
     INPUTPORT(in, W);
+
+private:
+    ShiftType m_type;
+    unsigned int m_shamt;
 };
 
 }  // namespace core
@@ -0,0 +1,79 @@
+#ifndef VSRTL_SNAPSHOT_H
+#define VSRTL_SNAPSHOT_H
+
+#include "../interface/vsrtl_defines.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace vsrtl {
+namespace core {
+
+/**
+ * @brief The SnapshotWriter class
+ * Encodes the state of a design into a compact binary blob (see Design::snapshot()). Integers are encoded as LEB128
+ * variable-length quantities, such that small values (which most state values are) occupy few bytes.
+ */
+class SnapshotWriter {
+public:
+    void writeVarint(uint64_t value) {
+        do {
+            uint8_t byte = value & 0x7F;
+            value >>= 7;
+            if (value != 0)
+                byte |= 0x80;
+            m_data.push_back(byte);
+        } while (value != 0);
+    }
+
+    void writeBytes(const uint8_t* bytes, size_t n) { m_data.insert(m_data.end(), bytes, bytes + n); }
+
+    std::vector<uint8_t> take() { return std::move(m_data); }
+
+private:
+    std::vector<uint8_t> m_data;
+};
+
+/**
+ * @brief The SnapshotReader class
+ * Decodes blobs created by SnapshotWriter.
+ * @throws std::runtime_error when reading beyond the end of the blob.
+ */
+class SnapshotReader {
+public:
+    explicit SnapshotReader(const std::vector<uint8_t>& data) : m_data(data) {}
+
+    uint64_t readVarint() {
+        uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            const uint8_t byte = readByte();
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return value;
+        }
+        throw std::runtime_error("Malformed design snapshot");
+    }
+
+    const uint8_t* readBytes(size_t n) {
+        if (m_data.size() - m_pos < n)
+            throw std::runtime_error("Truncated design snapshot");
+        const uint8_t* bytes = m_data.data() + m_pos;
+        m_pos += n;
+        return bytes;
+    }
+
+    bool atEnd() const { return m_pos == m_data.size(); }
+
+private:
+    uint8_t readByte() { return *readBytes(1); }
+
+    const std::vector<uint8_t>& m_data;
+    size_t m_pos = 0;
+};
+
+}  // namespace core
+}  // namespace vsrtl
+
+#endif  // VSRTL_SNAPSHOT_H
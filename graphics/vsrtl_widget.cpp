@@ -202,10 +202,14 @@ QFuture<void> VSRTLWidget::run(const std::function<void()>& cycleFunctor) {
                 while (!m_stop) {
                     m_design->clock();
                     cycleFunctor();
+                    if (m_design->breakpointHit())
+                        break;
                 }
             } else {
                 while (!m_stop) {
                     m_design->clock();
+                    if (m_design->breakpointHit())
+                        break;
                 }
             }
             m_stop = false;
@@ -46,8 +46,8 @@ public slots:
 
     /**
      * @brief run
-     * Asynchronously run the design until m_stop is asserted. @returns a future which may be watched to monitor run
-     * finishing.
+     * Asynchronously run the design until m_stop is asserted, or a breakpoint of the design is hit (see
+     * SimDesign::breakpointHit()). @returns a future which may be watched to monitor run finishing.
      * Additionally, a functor @param cycleFunctor can be passed to the function. This functor will be
      * executed after each clock cycle. Example uses of such functor could be; ie. if simulating a processor, whether
      * the prcoessor has hit a breakpoint and running needs to be terminated.
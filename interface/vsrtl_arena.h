@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace vsrtl {
+
+/**
+ * @brief The Arena class
+ * A bump allocator for the objects which describe a design (components, ports and parameters). Objects are allocated
+ * consecutively, in order of creation, within large blocks, such that the ports of a component are located next to
+ * each other and next to their component. All memory is released at once when the arena is destroyed; objects
+ * created in the arena must have been destroyed (see ArenaDeleter) prior to that.
+ */
+class Arena {
+public:
+    explicit Arena(size_t blockSize = 64 * 1024) : m_blockSize(blockSize) {}
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /// @pre @p alignment is a power of two, no larger than alignof(std::max_align_t).
+    void* allocate(size_t size, size_t alignment) {
+        size_t offset = (m_used + alignment - 1) & ~(alignment - 1);
+        if (m_blocks.empty() || offset + size > m_blockCapacity) {
+            // Objects larger than a block are given a block of their own
+            m_blockCapacity = std::max(m_blockSize, size);
+            m_blocks.push_back(std::make_unique<uint8_t[]>(m_blockCapacity));
+            // Blocks are aligned for any fundamental type
+            offset = 0;
+        }
+        m_used = offset + size;
+        m_bytesAllocated += size;
+        return m_blocks.back().get() + offset;
+    }
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        void* ptr = allocate(sizeof(T), alignof(T));
+        return new (ptr) T(std::forward<Args>(args)...);
+    }
+
+    /// Number of bytes handed out by the arena, excluding padding.
+    size_t bytesAllocated() const { return m_bytesAllocated; }
+    size_t blockCount() const { return m_blocks.size(); }
+
+private:
+    size_t m_blockSize;
+    size_t m_blockCapacity = 0;
+    size_t m_used = 0;
+    size_t m_bytesAllocated = 0;
+    std::vector<std::unique_ptr<uint8_t[]>> m_blocks;
+};
+
+/**
+ * @brief The ArenaDeleter struct
+ * Deleter of objects which may reside within an Arena. Such objects are destroyed in place; their memory is released
+ * along with the arena. Other objects are deleted.
+ */
+struct ArenaDeleter {
+    bool inArena = false;
+
+    template <typename T>
+    void operator()(T* ptr) const {
+        if (inArena)
+            ptr->~T();
+        else
+            delete ptr;
+    }
+};
+
+template <typename T>
+using ArenaPtr = std::unique_ptr<T, ArenaDeleter>;
+
+}  // namespace vsrtl
@@ -7,13 +7,17 @@
 #include <memory>
 #include <set>
 #include <stdexcept>
+#include <string_view>
 #include <type_traits>
 #include <typeindex>
+#include <unordered_map>
 #include <vector>
 
 #include "Signal.h"
+#include "vsrtl_arena.h"
 #include "vsrtl_defines.h"
 #include "vsrtl_gfxobjecttypes.h"
+#include "vsrtl_namedset.h"
 #include "vsrtl_parameter.h"
 #include "vsrtl_vcdfile.h"
 
@@ -41,12 +45,15 @@ public:
     const std::string& getName() const { return m_name; }
     const std::string& getDisplayName() const { return m_displayName.empty() ? m_name : m_displayName; }
     const std::string& getDescription() const { return m_description; }
-    const std::string getHierName() const {
-        if (m_parent) {
-            return m_parent->getHierName() + "->" + getName();
-        } else {
-            return getName();
-        }
+    /**
+     * @brief getHierName
+     * Returns the hierarchical name of this object (ie. "top->alu->out"). The name is built upon the first call, and
+     * cached thereafter; names and parents do not change once an object has been created.
+     */
+    const std::string& getHierName() const {
+        if (m_hierName.empty())
+            m_hierName = m_parent ? m_parent->getHierName() + "->" + getName() : getName();
+        return m_hierName;
     }
 
     template <typename T = SimBase>
@@ -83,14 +90,10 @@ protected:
     std::string m_description;
     /// An opaque pointer to a graphical counterpart to this component.
     void* m_graphicObject = nullptr;
-};
 
-template <typename T>
-struct BaseSorter {
-    bool operator()(const T& lhs, const T& rhs) const {
-        return std::lexicographical_compare(lhs->getName().begin(), lhs->getName().end(), rhs->getName().begin(),
-                                            rhs->getName().end());
-    }
+private:
+    /// Cached hierarchical name; see getHierName().
+    mutable std::string m_hierName;
 };
 
 class SimPort : public SimBase {
@@ -213,7 +216,6 @@ protected:
     SimPort* m_inputPort = nullptr;
 
 private:
-    void queueVcdVarChange();
     bool m_traversingConnection = false;
     std::string m_vcdId;
     /**
@@ -235,10 +237,11 @@ struct NoPredicate {};
 
 class SimComponent : public SimBase {
 public:
-    using PortBaseCompT = BaseSorter<std::unique_ptr<SimPort>>;
-    using ComponentCompT = BaseSorter<std::unique_ptr<SimComponent>>;
-
-    SimComponent(const std::string& name, SimBase* parent) : SimBase(name, parent) {}
+    SimComponent(const std::string& name, SimBase* parent) : SimBase(name, parent) {
+        // Subcomponents share the arena of their parent (see SimDesign)
+        if (auto* parentComponent = dynamic_cast<SimComponent*>(parent))
+            m_arena = parentComponent->m_arena;
+    }
     virtual ~SimComponent() {}
 
     /**
@@ -309,34 +312,35 @@ public:
 
     template <typename T = SimPort>
     T* findPort(const std::string& name) const {
-        T* p_ptr = nullptr;
-        for (const auto& p : getAllPorts<T>()) {
-            if (p->getName() == name) {
-                p_ptr = p;
-                break;
-            }
-        }
-        return p_ptr;
+        static_assert(std::is_base_of<SimPort, T>::value, "Must cast to a simulator-specific port type");
+        SimPort* p = m_inputPorts.find(name);
+        if (!p)
+            p = m_outputPorts.find(name);
+        return p ? p->template cast<T>() : nullptr;
     }
 
     template <typename T = SimPort>
     T* findSignal(const std::string& name) const {
-        T* p_ptr = nullptr;
-        for (const auto& p : getSignals<T>()) {
-            if (p->getName() == name) {
-                p_ptr = p;
-                break;
-            }
-        }
-        return p_ptr;
+        static_assert(std::is_base_of<SimPort, T>::value, "Must cast to a simulator-specific port type");
+        SimPort* p = m_signals.find(name);
+        return p ? p->template cast<T>() : nullptr;
+    }
+
+    template <typename T = SimComponent>
+    T* findSubComponent(const std::string& name) const {
+        static_assert(std::is_base_of<SimComponent, T>::value, "Must cast to a simulator-specific component type");
+        SimComponent* c = m_subcomponents.find(name);
+        return c ? c->cast<T>() : nullptr;
     }
 
     template <typename T = SimPort>
     std::vector<T*> getAllPorts() const {
         static_assert(std::is_base_of<SimPort, T>::value, "Must cast to a simulator-specific port type");
         std::vector<T*> ports;
-        for (auto portsForDir : {getPorts<SimPort::PortType::in, T>(), getPorts<SimPort::PortType::out, T>()}) {
-            ports.insert(ports.end(), portsForDir.begin(), portsForDir.end());
+        ports.reserve(m_inputPorts.size() + m_outputPorts.size());
+        for (const auto* portsForDir : {&m_inputPorts, &m_outputPorts}) {
+            for (const auto& p : *portsForDir)
+                ports.push_back(p->template cast<T>());
         }
         return ports;
     }
@@ -415,15 +419,13 @@ public:
     template <typename T, typename... Args>
     T* create_component(const std::string& name, Args... args) {
         verifyIsUniqueComponentName(name);
-        auto sptr = std::make_unique<T>(name, this, args...);
-        auto* ptr = sptr.get();
-        m_subcomponents.emplace(std::move(sptr));
-        return ptr->template cast<T>();
+        return m_subcomponents.insert(createObject<T>(name, this, args...))->template cast<T>();
     }
 
     template <typename T, typename... Args>
     std::vector<T*> create_components(const std::string& name, unsigned int n, Args... args) {
         std::vector<T*> components;
+        components.reserve(n);
         for (unsigned int i = 0; i < n; i++) {
             std::string i_name = name + "_" + std::to_string(i);
             components.push_back(create_component<T, Args...>(i_name, args...));
@@ -434,12 +436,24 @@ public:
     template <typename T>
     Parameter<T>& createParameter(const std::string& name, const T& value) {
         verifyIsUniqueParameterName(name);
-        auto sptr = std::make_unique<Parameter<T>>(name, value);
+        auto sptr = createObject<Parameter<T>>(name, value);
         auto* ptr = sptr.get();
         m_parameters.emplace(std::move(sptr));
         return *ptr;
     }
 
+    /**
+     * @brief createObject
+     * Creates an object owned by this component (a subcomponent, port or parameter) within the arena of the design,
+     * if this component is part of one, and on the heap otherwise.
+     */
+    template <typename T, typename... Args>
+    ArenaPtr<T> createObject(Args&&... args) {
+        if (m_arena)
+            return ArenaPtr<T>(m_arena->create<T>(std::forward<Args>(args)...), ArenaDeleter{true});
+        return ArenaPtr<T>(new T(std::forward<Args>(args)...), ArenaDeleter{false});
+    }
+
     std::vector<ParameterBase*> getParameters() const {
         std::vector<ParameterBase*> parameters;
         for (const auto& p : m_parameters) {
@@ -449,14 +463,14 @@ public:
     }
 
     void verifyIsUniquePortName(const std::string& name) {
-        if (!(isUniqueName(name, m_outputPorts) && isUniqueName(name, m_inputPorts))) {
+        if (m_outputPorts.contains(name) || m_inputPorts.contains(name)) {
             throw std::runtime_error("Duplicate port name: '" + name + "' in component: '" + getName() +
                                      "'. Port names must be unique.");
         }
     }
 
     void verifyIsUniqueComponentName(const std::string& name) {
-        if (!isUniqueName(name, m_subcomponents)) {
+        if (m_subcomponents.contains(name)) {
             throw std::runtime_error("Duplicate subcomponent name: '" + name + "' in component: '" + getName() +
                                      "'. Subcomponent names must be unique.");
         }
@@ -470,7 +484,7 @@ public:
     }
 
     template <typename T, typename C_T>
-    bool isUniqueName(const std::string& name, std::set<std::unique_ptr<T>, C_T>& container) {
+    bool isUniqueName(const std::string& name, std::set<ArenaPtr<T>, C_T>& container) {
         return std::find_if(container.begin(), container.end(),
                             [name](const auto& p) { return p->getName() == name; }) == container.end();
     }
@@ -531,15 +545,30 @@ public:
     Gallant::Signal0<> changed;
 
 protected:
-    // Ports and subcomponents should be maintained as sorted sets based on port and component names, ensuring
-    // consistent ordering between executions
-    using PortSet = std::set<std::unique_ptr<SimPort>, PortBaseCompT>;
+    /**
+     * @brief destroyHierarchy
+     * Destroys all subcomponents, ports and parameters of this component, in the order in which they would otherwise
+     * be destroyed along with the component.
+     */
+    void destroyHierarchy() {
+        m_specialPorts.clear();
+        m_parameters.clear();
+        m_subcomponents.clear();
+        m_signals.clear();
+        m_inputPorts.clear();
+        m_outputPorts.clear();
+    }
+
+    // Ports and subcomponents are iterated in order of their names, ensuring consistent ordering between executions
+    using PortSet = NamedSet<SimPort>;
     PortSet m_outputPorts;
     PortSet m_inputPorts;
     PortSet m_signals;
-    std::set<std::unique_ptr<SimComponent>, ComponentCompT> m_subcomponents;
-    std::set<std::unique_ptr<ParameterBase>> m_parameters;
+    NamedSet<SimComponent> m_subcomponents;
+    std::set<ArenaPtr<ParameterBase>> m_parameters;
     std::map<std::string, SimPort*> m_specialPorts;
+    /// Arena in which the objects owned by this component are created; see createObject().
+    Arena* m_arena = nullptr;
     bool m_activeComp = false;
     bool m_activeCompFsm = false;
     bool m_activeCompFsmCol = false;
@@ -573,8 +602,17 @@ private:
 
 class SimDesign : public SimComponent {
 public:
-    SimDesign(const std::string& name, SimBase* parent) : SimComponent(name, parent) {}
-    virtual ~SimDesign() {}
+    SimDesign(const std::string& name, SimBase* parent) : SimComponent(name, parent) { m_arena = &m_designArena; }
+    virtual ~SimDesign() {
+        // All objects of the design must be destroyed before the arena in which they reside
+        destroyHierarchy();
+    }
+
+    /**
+     * @brief arena
+     * The arena in which all components, ports and parameters of this design are allocated, in order of creation.
+     */
+    const Arena& arena() const { return m_designArena; }
     /**
      * @brief clock
      * Simulates clocking the circuit. Registers are clocked and the propagation algorithm is run
@@ -635,19 +673,60 @@ public:
         }
     }
 
+    /**
+     * @brief restored
+     * Called by the simulator once the design has been restored to a previously recorded state (ie. of an arbitrary
+     * cycle). The circuit shall have been repropagated to reflect the restored state.
+     */
+    virtual void restored() {
+#ifndef NDEBUG
+        m_cycleCountPre = -1;
+#endif
+        if (clockedSignalsEnabled()) {
+            designWasRestored.Emit();
+        }
+    }
+
     /**
      * @brief canReverse
      * @return is the simulator able to reverse?
      */
     virtual bool canReverse() const = 0;
 
+    /**
+     * @brief breakpointHit
+     * @return whether a breakpoint of the design was hit in the last clocked cycle. Run loops shall stop once this
+     * holds.
+     */
+    virtual bool breakpointHit() const { return false; }
+
     /**
      * @brief verifyAndInitialize
      * Any post-construction initialization should be included in this function.
      */
-    virtual void verifyAndInitialize() { m_isVerifiedAndInitialized = true; }
+    virtual void verifyAndInitialize() {
+        createPathIndex();
+        m_isVerifiedAndInitialized = true;
+    }
     bool isVerifiedAndInitialized() const { return m_isVerifiedAndInitialized; }
 
+    /**
+     * @brief lookup
+     * Resolves the hierarchical path @p path of a component or port of this design, relative to the design (ie.
+     * "alu->out") or including the name of the design (ie. "<design>->alu->out"). Once the design has been
+     * initialized, paths are resolved in constant time through an index over the hierarchical names of all objects of
+     * the design; prior to that, the hierarchy is walked.
+     * @returns nullptr if no such object exists, or if it is not of type T.
+     */
+    template <typename T = SimBase>
+    T* lookup(const std::string& path) const {
+        SimBase* object = lookupPath(path);
+        const std::string prefix = getName() + "->";
+        if (!object && path.compare(0, prefix.size(), prefix) == 0)
+            object = lookupPath(path.substr(prefix.size()));
+        return dynamic_cast<T*>(object);
+    }
+
     /**
      * m_emitsSignals related functions
      * signalsEnabled() may be used by child components and ports of this design, to emit status change signals.
@@ -668,25 +747,22 @@ public:
 
     long long getCycleCount() const { return m_cycleCount; }
 
+    /**
+     * @brief setEnableChangeSets
+     * Enables batched change notification. The ports which changed value during a call to clock(), reverse(),
+     * propagate() or reset() (or when forcing a synchronous value) are collected, and emitted as a single change set
+     * through portsChanged once the operation has completed. Change sets are collected independently of whether
+     * per-port signals are enabled.
+     */
+    void setEnableChangeSets(bool state) { m_emitsChangeSets = state; }
+    bool changeSetsEnabled() const { return m_emitsChangeSets; }
+
     /**
      * @brief vcdDump
-     * @param enabled; enables dumping of all ports to a vcd file. For each port in the circuit, we connect an
-     * additional slot which will queue a notice to this top-level Design that the variable change is to be written to
-     * the VCD file.
+     * @param enabled; enables dumping of all ports to a vcd file. Variable changes are written based on the change set
+     * of each cycle.
      */
-    void vcdDump(bool enabled) {
-        m_dumpVcdFiles = enabled;
-        std::map<SimComponent*, std::vector<SimComponent*>> componentGraph;
-        getComponentGraph(componentGraph);
-        for (const auto& compIt : componentGraph) {
-            for (const auto& port : compIt.first->getAllPorts()) {
-                port->changed.Disconnect(port, &SimPort::queueVcdVarChange);
-                if (enabled) {
-                    port->changed.Connect(port, &SimPort::queueVcdVarChange);
-                }
-            }
-        }
-    }
+    void vcdDump(bool enabled) { m_dumpVcdFiles = enabled; }
 
     /**
      * @brief vcdDump
@@ -718,14 +794,9 @@ public:
 
     /**
      * @brief queueVcdVarChange
-     * Caled by @param port to enqueue a notice of the fact that the port has changed its value in the current cycle.
+     * Enqueues a notice of the fact that @param port has changed its value in the current cycle.
      */
-    void queueVcdVarChange(const SimPort* port) {
-        if (m_vcdVarChangeQueue.count(port) != 0) {
-            throw std::runtime_error("Multiple changes for port " + port->getHierName() + " during a single cycle");
-        }
-        m_vcdVarChangeQueue.insert(port);
-    }
+    void queueVcdVarChange(const SimPort* port) { m_vcdVarChangeQueue.insert(port); }
 
     /**
      * @brief dumpVcdVarChanges
@@ -748,20 +819,101 @@ public:
     }
 
     /**
-     * @brief clocked, reversed & reset signals
+     * @brief clocked, reversed, reset & restored signals
      * These signals are emitted whenever the design has finished an entire clockcycle (clock + signal propagation).
      * Signals are emitted if m_emitsClockedSignals is set.
      */
     Gallant::Signal0<> designWasClocked;
     Gallant::Signal0<> designWasReversed;
     Gallant::Signal0<> designWasReset;
+    Gallant::Signal0<> designWasRestored;
+
+    /**
+     * @brief portsChanged
+     * Emitted with the change set of each operation on the design, if change sets are enabled (see
+     * setEnableChangeSets()). Emitted prior to designWasClocked/designWasReversed/designWasReset/designWasRestored.
+     */
+    Gallant::Signal1<const std::vector<SimPort*>&> portsChanged;
 
 protected:
+    /**
+     * @brief recordsChanges
+     * Simulators shall collect the ports which changed value during each operation on the design whenever this is
+     * true, and report these through changeSetReady().
+     */
+    bool recordsChanges() const { return m_emitsChangeSets || m_dumpVcdFiles; }
+
+    /**
+     * @brief changeSetReady
+     * Called by the simulator with the set of ports which changed value during the current operation on the design.
+     */
+    void changeSetReady(const std::vector<SimPort*>& ports) {
+        if (m_dumpVcdFiles) {
+            for (const auto& port : ports)
+                queueVcdVarChange(port);
+        }
+        if (m_emitsChangeSets && !ports.empty()) {
+            portsChanged.Emit(ports);
+        }
+    }
+
     long long m_cycleCount = 0;
     bool m_emitsSignals = true;
 
 private:
+    /**
+     * @brief createPathIndex
+     * Indexes all components and ports of the design by their hierarchical path relative to the design. Keys refer to
+     * the cached hierarchical names of the objects (see SimBase::getHierName()).
+     */
+    void createPathIndex() {
+        m_pathIndex.clear();
+        const size_t prefixLength = getHierName().size() + 2;
+        auto index = [&](SimBase* object) {
+            m_pathIndex.emplace(std::string_view(object->getHierName()).substr(prefixLength), object);
+        };
+        std::vector<SimComponent*> stack = {this};
+        while (!stack.empty()) {
+            SimComponent* c = stack.back();
+            stack.pop_back();
+            for (auto* p : c->getAllPorts())
+                index(p);
+            for (auto* p : c->getSignals())
+                index(p);
+            for (auto* sc : c->getSubComponents()) {
+                index(sc);
+                stack.push_back(sc);
+            }
+        }
+    }
+
+    SimBase* lookupPath(const std::string& path) const {
+        if (m_isVerifiedAndInitialized) {
+            auto it = m_pathIndex.find(path);
+            return it == m_pathIndex.end() ? nullptr : it->second;
+        }
+
+        const SimComponent* c = this;
+        size_t start = 0;
+        for (size_t end = path.find("->"); end != std::string::npos; end = path.find("->", start)) {
+            c = c->findSubComponent(path.substr(start, end - start));
+            if (!c)
+                return nullptr;
+            start = end + 2;
+        }
+        const std::string name = path.substr(start);
+        if (auto* sc = c->findSubComponent(name))
+            return sc;
+        if (auto* p = c->findPort(name))
+            return p;
+        return c->findSignal(name);
+    }
+
+    /// Components and ports of the design, by their path relative to the design; see lookup().
+    std::unordered_map<std::string_view, SimBase*> m_pathIndex;
+    Arena m_designArena;
     bool m_emitsClockedSignals = true;
+    bool m_emitsChangeSets = false;
     bool m_isVerifiedAndInitialized = false;
 
     // VCD dump members
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <assert.h>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "vsrtl_arena.h"
+
+namespace vsrtl {
+
+template <typename T>
+struct BaseSorter {
+    // Transparent, such that objects may be looked up by name
+    using is_transparent = void;
+    bool operator()(const T& lhs, const T& rhs) const { return less(lhs->getName(), rhs->getName()); }
+    bool operator()(const T& lhs, const std::string& rhs) const { return less(lhs->getName(), rhs); }
+    bool operator()(const std::string& lhs, const T& rhs) const { return less(lhs, rhs->getName()); }
+
+private:
+    static bool less(const std::string& lhs, const std::string& rhs) {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+};
+
+/**
+ * @brief The NamedSet class
+ * Owns a set of uniquely named objects (ports or subcomponents of a component). Objects are stored in a flat vector
+ * and iterated in order of their names, ensuring consistent ordering between executions. Once the set grows beyond a
+ * few objects, a hashed index over the names provides constant time lookup, such that creating n objects does not
+ * cost O(n^2) name comparisons. Smaller sets (ie. the ports of most components) are searched linearly.
+ * Objects are appended upon insertion, and the vector is only sorted upon the first traversal which follows an
+ * out-of-order insertion. As such, the set must not be traversed concurrently with, or directly after, insertions
+ * from multiple threads; designs are elaborated, and thus traversed, on a single thread.
+ */
+template <typename T>
+class NamedSet {
+public:
+    using Ptr = ArenaPtr<T>;
+    using const_iterator = typename std::vector<Ptr>::const_iterator;
+
+    /// @pre No object named as @p obj is present in the set.
+    T* insert(Ptr obj) {
+        T* ptr = obj.get();
+        assert(!contains(ptr->getName()));
+        if (m_sorted && !m_items.empty() && BaseSorter<Ptr>()(obj, m_items.back()->getName()))
+            m_sorted = false;
+        m_items.push_back(std::move(obj));
+        if (!m_index.empty()) {
+            // The index is kept at most half full
+            if (2 * m_items.size() > m_index.size())
+                rebuildIndex(2 * m_index.size());
+            else
+                indexObject(hash(ptr->getName()), ptr);
+        } else if (m_items.size() > s_indexThreshold) {
+            rebuildIndex(4 * s_indexThreshold);
+        }
+        return ptr;
+    }
+
+    T* find(const std::string& name) const {
+        if (m_index.empty()) {
+            for (const auto& item : m_items) {
+                if (item->getName() == name)
+                    return item.get();
+            }
+            return nullptr;
+        }
+        const size_t h = hash(name);
+        const size_t mask = m_index.size() - 1;
+        for (size_t i = h & mask;; i = (i + 1) & mask) {
+            const Slot& slot = m_index[i];
+            if (slot.object == nullptr)
+                return nullptr;
+            if (slot.hash == h && slot.object->getName() == name)
+                return slot.object;
+        }
+    }
+    bool contains(const std::string& name) const { return find(name) != nullptr; }
+
+    const_iterator begin() const {
+        sort();
+        return m_items.begin();
+    }
+    const_iterator end() const { return m_items.end(); }
+
+    size_t size() const { return m_items.size(); }
+    bool empty() const { return m_items.empty(); }
+    void clear() {
+        m_index.clear();
+        m_items.clear();
+        m_sorted = true;
+    }
+
+private:
+    static constexpr size_t s_indexThreshold = 16;
+
+    /// An open addressed (linearly probed) entry of the index. The hash of the name of the object is retained, such
+    /// that probing rarely has to compare names.
+    struct Slot {
+        size_t hash;
+        T* object;
+    };
+
+    static size_t hash(const std::string& name) { return std::hash<std::string>()(name); }
+
+    /// @pre @p capacity is a power of two, larger than the number of objects in the set.
+    void rebuildIndex(size_t capacity) {
+        m_index.assign(capacity, Slot{0, nullptr});
+        for (const auto& item : m_items)
+            indexObject(hash(item->getName()), item.get());
+    }
+
+    void indexObject(size_t h, T* object) {
+        const size_t mask = m_index.size() - 1;
+        size_t i = h & mask;
+        while (m_index[i].object != nullptr)
+            i = (i + 1) & mask;
+        m_index[i] = {h, object};
+    }
+
+    void sort() const {
+        if (m_sorted)
+            return;
+        // Indices are sorted by the same comparator as used by insert(), such that the objects are only moved once
+        std::vector<size_t> order(m_items.size());
+        std::iota(order.begin(), order.end(), size_t(0));
+        const BaseSorter<Ptr> less{};
+        std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) { return less(m_items[lhs], m_items[rhs]); });
+        std::vector<Ptr> sorted;
+        sorted.reserve(m_items.size());
+        for (const size_t i : order)
+            sorted.push_back(std::move(m_items[i]));
+        m_items = std::move(sorted);
+        m_sorted = true;
+    }
+
+    mutable std::vector<Ptr> m_items;
+    mutable bool m_sorted = true;
+    /// Empty while the set holds no more than s_indexThreshold objects; otherwise a power of two in size.
+    std::vector<Slot> m_index;
+};
+
+}  // namespace vsrtl
@@ -0,0 +1,122 @@
+#include <QtTest/QTest>
+
+#include "tst_utils.h"
+#include "vsrtl_aluandreg.h"
+#include "vsrtl_batchsimulator.h"
+#include "vsrtl_counter.h"
+#include "vsrtl_enumandmux.h"
+#include "vsrtl_rannumgen.h"
+#include "vsrtl_xornetwork.h"
+
+using namespace vsrtl;
+using namespace core;
+using namespace test;
+
+class tst_batchSimulation : public QObject {
+    Q_OBJECT
+
+private slots:
+    void ranNumGen();
+    void enumAndMux();
+    void aluAndReg();
+    void counter();
+    void xorNetwork();
+    void unobservedPorts();
+    void unsupportedDesign();
+};
+
+namespace {
+
+std::vector<VSRTL_VT_U> distinctSeeds(unsigned n) {
+    std::vector<VSRTL_VT_U> seeds;
+    for (unsigned i = 0; i < n; i++)
+        seeds.push_back(0x9e3779b97f4a7c15ull * (i + 1));
+    return seeds;
+}
+
+/**
+ * Simulates instances of design D in batch, where the register returned by @p seedRegister is forced to
+ * @p seeds[lane] in each lane. Each lane is verified against an individually simulated instance of the design.
+ * If @p eliminateUnobserved, unobserved ports are eliminated from the batch simulated design.
+ */
+template <typename D, typename F>
+void verifyLanes(F seedRegister, const std::vector<VSRTL_VT_U>& seeds, unsigned cycles,
+                 bool eliminateUnobserved = false) {
+    const unsigned lanes = seeds.size();
+    D batchDesign;
+    batchDesign.setEliminateUnobservedPorts(eliminateUnobserved);
+    batchDesign.verifyAndInitialize();
+    QVERIFY(!eliminateUnobserved || batchDesign.unobservedPortCount() > 0);
+    BatchSimulator batch(batchDesign, lanes);
+
+    std::vector<std::unique_ptr<D>> refs;
+    for (unsigned lane = 0; lane < lanes; lane++) {
+        refs.push_back(std::make_unique<D>());
+        auto& ref = *refs.back();
+        ref.verifyAndInitialize();
+        ref.setEnableSignals(false);
+
+        ref.setSynchronousValue(seedRegister(ref), 0, seeds[lane]);
+        batch.setRegisterValue(seedRegister(batchDesign), lane, seeds[lane]);
+    }
+    batch.propagate();
+
+    std::vector<PortBase*> batchPorts;
+    collectPorts(&batchDesign, batchPorts);
+    std::vector<std::vector<PortBase*>> refPorts(lanes);
+    for (unsigned lane = 0; lane < lanes; lane++)
+        collectPorts(refs[lane].get(), refPorts[lane]);
+
+    for (unsigned cycle = 0; cycle <= cycles; cycle++) {
+        for (unsigned lane = 0; lane < lanes; lane++) {
+            for (unsigned i = 0; i < batchPorts.size(); i++) {
+                if (batch.value(batchPorts[i], lane) != refPorts[lane][i]->uValue()) {
+                    QFAIL(("Mismatch at cycle " + std::to_string(cycle) + ", lane " + std::to_string(lane) +
+                           " for port " + batchPorts[i]->getHierName())
+                              .c_str());
+                }
+            }
+        }
+        batch.clock();
+        for (auto& ref : refs)
+            ref->clock();
+    }
+}
+
+}  // namespace
+
+void tst_batchSimulation::ranNumGen() {
+    verifyLanes<RanNumGen>([](RanNumGen& d) { return d.rngResReg; }, distinctSeeds(17), 100);
+}
+
+void tst_batchSimulation::enumAndMux() {
+    // Each lane selects a different multiplexer input
+    verifyLanes<EnumAndMux>([](EnumAndMux& d) { return d.reg; }, {0, 1, 2, 3, 4, 5}, 20);
+}
+
+void tst_batchSimulation::aluAndReg() {
+    verifyLanes<ALUAndReg>([](ALUAndReg& d) { return d.reg; }, distinctSeeds(8), 50);
+}
+
+void tst_batchSimulation::counter() {
+    verifyLanes<Counter<8>>([](Counter<8>& d) { return d.regs[3]; }, {0, 1, 0, 1, 1}, 300);
+}
+
+void tst_batchSimulation::xorNetwork() {
+    verifyLanes<XorNetwork>([](XorNetwork& d) { return d.seedReg; }, distinctSeeds(4), 10);
+}
+
+void tst_batchSimulation::unobservedPorts() {
+    // Ports eliminated from the propagation stack of the design are still simulated in batch
+    verifyLanes<XorNetwork>([](XorNetwork& d) { return d.seedReg; }, distinctSeeds(4), 10, true);
+}
+
+void tst_batchSimulation::unsupportedDesign() {
+    // Designs with memories cannot be batch simulated
+    leros::SingleCycleLeros design;
+    design.verifyAndInitialize();
+    QVERIFY_EXCEPTION_THROWN(BatchSimulator(design, 4), std::runtime_error);
+}
+
+QTEST_APPLESS_MAIN(tst_batchSimulation)
+#include "tst_batchsimulation.moc"
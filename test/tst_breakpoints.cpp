@@ -0,0 +1,158 @@
+#include <QtTest/QTest>
+
+#include "tst_utils.h"
+#include "vsrtl_counter.h"
+#include "vsrtl_design.h"
+
+using namespace vsrtl;
+using namespace core;
+using namespace test;
+
+class tst_breakpoints : public QObject {
+    Q_OBJECT private slots : void portConditions();
+    void edgeTriggeredConditions();
+    void writeWatches();
+    void memoryConditions();
+    void sharedWriteObservers();
+    void unobservedPorts();
+};
+
+void tst_breakpoints::portConditions() {
+    Counter<8> counter;
+    // Conditions may be set prior to elaboration, which relocates the ports they refer to
+    const auto id = counter.breakpoints().addCondition(counter.value->out, BreakpointEngine::Compare::eq, 5);
+    counter.verifyAndInitialize();
+
+    auto result = counter.runCycles(1000);
+    QVERIFY(result.stopped);
+    QCOMPARE(counter.getCycleCount(), 5LL);
+    QVERIFY(counter.breakpointHit());
+    QCOMPARE(counter.breakpoints().hits(), std::vector<BreakpointEngine::Id>{id});
+
+    // A level triggered condition hits in every cycle in which it holds
+    counter.clock();
+    QVERIFY(!counter.breakpointHit());
+    result = counter.runCycles(1000);
+    QCOMPARE(counter.getCycleCount(), 256LL + 5);
+
+    counter.breakpoints().remove(id);
+    QVERIFY(!counter.breakpoints().armed());
+    result = counter.runCycles(1000);
+    QVERIFY(!result.stopped);
+    QCOMPARE(result.cycles, 1000LL);
+}
+
+void tst_breakpoints::edgeTriggeredConditions() {
+    Counter<8> counter;
+    counter.verifyAndInitialize();
+    counter.breakpoints().addCondition(counter.value->out, BreakpointEngine::Compare::gt, 250,
+                                       BreakpointEngine::Trigger::edge);
+
+    // The value rises above 250 once per period of the counter
+    counter.runCycles(1000);
+    QCOMPARE(counter.getCycleCount(), 251LL);
+    counter.runCycles(1000);
+    QCOMPARE(counter.getCycleCount(), 256LL + 251);
+
+    // Reversing and clocking across the edge hits again
+    counter.reverse();
+    QVERIFY(!counter.breakpointHit());
+    counter.clock();
+    QVERIFY(counter.breakpointHit());
+    counter.clock();
+    QVERIFY(!counter.breakpointHit());
+}
+
+void tst_breakpoints::writeWatches() {
+    auto design = createLeros();
+    QVERIFY_EXCEPTION_THROWN(design->breakpoints().addWriteWatch(*design->m_memory, 0x100, 0), std::runtime_error);
+    design->breakpoints().addWriteWatch(*design->m_memory, 0x200, 4);
+    QVERIFY(!design->runCycles(100).stopped);
+
+    design->breakpoints().clear();
+    design->breakpoints().addWriteWatch(*design->m_memory, 0x100);
+    design->runCycles(1000);
+    QVERIFY(design->breakpointHit());
+
+    // Each hit is the cycle in which the value at 0x100 is incremented
+    for (int i = 0; i < 4; i++) {
+        const auto value = design->m_memory->readMemConst(0x100, 1);
+        const auto result = design->runCycles(1000);
+        QVERIFY(result.stopped);
+        QVERIFY(result.cycles > 1);
+        QCOMPARE(design->m_memory->readMemConst(0x100, 1), value + 1);
+        // Writes when reversing are not breakpoints
+        design->reverse();
+        QCOMPARE(design->m_memory->readMemConst(0x100, 1), value);
+        QVERIFY(!design->breakpointHit());
+        design->clock();
+        QVERIFY(design->breakpointHit());
+    }
+}
+
+void tst_breakpoints::memoryConditions() {
+    auto design = createLeros();
+    QVERIFY_EXCEPTION_THROWN(
+        design->breakpoints().addMemoryCondition(*design->m_memory, 0x100, 0, BreakpointEngine::Compare::eq, 0),
+        std::runtime_error);
+
+    // The value at 0x100 is incremented by the program
+    const auto id =
+        design->breakpoints().addMemoryCondition(*design->m_memory, 0x100, 4, BreakpointEngine::Compare::eq, 3);
+    QVERIFY(design->runCycles(1000).stopped);
+    QCOMPARE(design->m_memory->readMemConst(0x100, 4), VSRTL_VT_U(3));
+    QCOMPARE(design->breakpoints().hits(), std::vector<BreakpointEngine::Id>{id});
+    design->reverse();
+    QCOMPARE(design->m_memory->readMemConst(0x100, 4), VSRTL_VT_U(2));
+    design->clock();
+    QVERIFY(design->breakpointHit());
+
+    // An edge triggered condition hits once as the value reaches the threshold
+    design->breakpoints().clear();
+    design->breakpoints().addMemoryCondition(*design->m_memory, 0x100, 1, BreakpointEngine::Compare::ge, 5,
+                                             BreakpointEngine::Trigger::edge);
+    QVERIFY(design->runCycles(1000).stopped);
+    QCOMPARE(design->m_memory->readMemConst(0x100, 1), VSRTL_VT_U(5));
+    QVERIFY(!design->runCycles(100).stopped);
+}
+
+void tst_breakpoints::sharedWriteObservers() {
+    // Observers of an address space other than the breakpoint engine are retained when watches are removed
+    auto design = createLeros();
+    unsigned writes = 0;
+    const auto observer = design->m_memory->addWriteObserver([&](VSRTL_VT_U, int) { writes++; });
+    const auto id = design->breakpoints().addWriteWatch(*design->m_memory, 0x100);
+    design->runCycles(1000);
+    QVERIFY(design->breakpointHit());
+    QVERIFY(writes > 0);
+
+    design->breakpoints().remove(id);
+    design->breakpoints().addWriteWatch(*design->m_memory, 0x100);
+    design->breakpoints().clear();
+    const unsigned preWrites = writes;
+    QVERIFY(!design->runCycles(20).stopped);
+    QVERIFY(writes > preWrites);
+    design->m_memory->removeWriteObserver(observer);
+}
+
+void tst_breakpoints::unobservedPorts() {
+    // Conditions on ports which were eliminated as unobserved are evaluated on propagated values. The carry out of the
+    // last adder is only set when the counter overflows, and nothing reads it.
+    Counter<8> counter;
+    counter.setEliminateUnobservedPorts(true);
+    counter.verifyAndInitialize();
+    QVERIFY(counter.unobservedPortCount() > 0);
+    counter.setEnableSignals(false);
+
+    counter.breakpoints().addCondition(counter.adders[7]->Cout, BreakpointEngine::Compare::eq, 1);
+    QVERIFY(counter.runCycles(1000).stopped);
+    QCOMPARE(counter.getCycleCount(), 255LL);
+
+    counter.reset();
+    for (unsigned i = 0; i < 255; i++)
+        counter.clock();
+    QVERIFY(counter.breakpointHit());
+}
+
+QTEST_APPLESS_MAIN(tst_breakpoints)
+#include "tst_breakpoints.moc"
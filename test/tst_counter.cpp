@@ -11,6 +11,15 @@ class tst_counter : public QObject {
     Q_OBJECT
 private slots:
     void clockTest();
+    void notifyPolicy();
+    void runCycles();
+    void runCyclesUnobserved();
+
+public:
+    void portChanged() { m_changes++; }
+
+private:
+    unsigned m_changes = 0;
 };
 
 template <int n>
@@ -41,5 +50,69 @@ void tst_counter::clockTest() {
     testCounter<4>();
     testCounter<8>();
 }
+
+void tst_counter::notifyPolicy() {
+    vsrtl::core::Counter<4> counter;
+    counter.addNotifyRule("regs_3", PortBase::NotifyPolicy::always);
+    counter.verifyAndInitialize();
+    QVERIFY(counter.regs[3]->out.notifyPolicy() == PortBase::NotifyPolicy::always);
+    QVERIFY(counter.regs[2]->out.notifyPolicy() == PortBase::NotifyPolicy::onChange);
+
+    counter.regs[3]->out.changed.Connect(this, &tst_counter::portChanged);
+    counter.regs[2]->out.changed.Connect(this, &tst_counter::portChanged);
+
+    // regs_3 notifies in every cycle, whereas regs_2 only notifies when toggling (cycles 4 and 8)
+    for (unsigned i = 0; i < 10; i++)
+        counter.clock();
+    QCOMPARE(m_changes, 12u);
+}
+
+void tst_counter::runCycles() {
+    vsrtl::core::Counter<8> counter;
+    counter.verifyAndInitialize();
+    m_changes = 0;
+    unsigned clocked = 0;
+    counter.designWasClocked.Connect([&] { clocked++; });
+    counter.value->out.changed.Connect(this, &tst_counter::portChanged);
+
+    auto result = counter.runCycles(10);
+    QCOMPARE(result.cycles, 10LL);
+    QVERIFY(!result.stopped);
+    QCOMPARE(counter.value->out.uValue(), VSRTL_VT_U(10));
+    QCOMPARE(counter.getCycleCount(), 10LL);
+    // Observers are notified once per run
+    QCOMPARE(clocked, 1u);
+    QCOMPARE(m_changes, 1u);
+
+    result = counter.runCycles(1000, counter.value->out, 200);
+    QCOMPARE(result.cycles, 190LL);
+    QVERIFY(result.stopped);
+    QCOMPARE(counter.value->out.uValue(), VSRTL_VT_U(200));
+
+    result = counter.runCycles(1000, [&] { return counter.value->out.uValue() % 64 == 0; });
+    QCOMPARE(result.cycles, 56LL);
+    QCOMPARE(counter.value->out.uValue(), VSRTL_VT_U(0));
+    QVERIFY(result.elapsed.count() > 0);
+    QVERIFY(result.cyclesPerSecond() > 0);
+    QCOMPARE(clocked, 3u);
+    QCOMPARE(m_changes, 3u);
+
+    // The cycles which were run may be reversed
+    counter.reverse();
+    QCOMPARE(counter.value->out.uValue(), VSRTL_VT_U(255));
+}
+
+void tst_counter::runCyclesUnobserved() {
+    // The carry out of the last adder is only set when the counter overflows, and nothing reads it
+    vsrtl::core::Counter<8> counter;
+    counter.setEliminateUnobservedPorts(true);
+    counter.verifyAndInitialize();
+    QVERIFY(counter.unobservedPortCount() > 0);
+
+    const auto result = counter.runCycles(1000, counter.adders[7]->Cout, 1);
+    QVERIFY(result.stopped);
+    QCOMPARE(counter.value->out.uValue(), VSRTL_VT_U(255));
+}
+
 QTEST_APPLESS_MAIN(tst_counter)
 #include "tst_counter.moc"
@@ -0,0 +1,258 @@
+#include <QtTest/QTest>
+
+#include "tst_utils.h"
+#include "vsrtl_design.h"
+#include "vsrtl_logicgate.h"
+#include "vsrtl_multiplexer.h"
+#include "vsrtl_nestedexponenter.h"
+#include "vsrtl_register.h"
+#include "vsrtl_xornetwork.h"
+
+#include <filesystem>
+
+using namespace vsrtl;
+using namespace core;
+using namespace test;
+
+namespace {
+
+// A register driving itself through a chain of inverters, deeper than what recursive elaboration could handle
+class InverterChain : public Design {
+public:
+    static constexpr unsigned int depth = 100001;
+
+    InverterChain() : Design("Inverter chain") {
+        reg->out >> *inverters[0]->in[0];
+        for (unsigned int i = 1; i < depth; i++)
+            inverters[i - 1]->out >> *inverters[i]->in[0];
+        inverters[depth - 1]->out >> reg->in;
+    }
+
+    SUBCOMPONENT(reg, Register<1>);
+    SUBCOMPONENTS(inverters, TYPE(Not<1, 1>), depth);
+};
+
+std::string scheduleCacheDirectory() {
+    const auto dir = std::filesystem::temp_directory_path() / "vsrtl_tst_elaboration";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir.string();
+}
+
+std::unique_ptr<leros::SingleCycleLeros> createLeros(const std::string& cacheDirectory) {
+    // Increments a value in register 0
+    static std::vector<unsigned short> program = {0x2000, 0x0901, 0x3000, 0x8FFD};
+    auto design = std::make_unique<leros::SingleCycleLeros>();
+    design->m_memory->addInitializationMemory(0x0, program.data(), program.size());
+    design->setScheduleCacheDirectory(cacheDirectory);
+    return design;
+}
+
+}  // namespace
+
+class tst_elaboration : public QObject {
+    Q_OBJECT private slots : void deepChain();
+    void elaborationTimes();
+    void scheduleCache();
+    void scheduleCacheInvalidation();
+    void arenaAllocation();
+    void relocatedPortData();
+    void wideComponents();
+    void pathLookup();
+};
+
+void tst_elaboration::deepChain() {
+    InverterChain design;
+    design.verifyAndInitialize();
+    QCOMPARE(design.propagationStackSize(), size_t(InverterChain::depth + 1));
+
+    // An odd number of inverters toggles the register in each cycle
+    for (unsigned int i = 0; i < 4; i++) {
+        QCOMPARE(design.reg->out.uValue(), VSRTL_VT_U(i % 2));
+        QCOMPARE(design.inverters.back()->out.uValue(), VSRTL_VT_U((i + 1) % 2));
+        design.clock();
+    }
+}
+
+void tst_elaboration::elaborationTimes() {
+    ScalableXorNetwork<200> design;
+    design.verifyAndInitialize();
+
+    const auto& times = design.elaborationTimes();
+    QVERIFY(!times.empty());
+    QCOMPARE(times.front().first, std::string("component graph"));
+    QCOMPARE(times.back().first, std::string("reset"));
+    std::chrono::nanoseconds total{0};
+    for (const auto& stage : times) {
+        QVERIFY(stage.second.count() >= 0);
+        total += stage.second;
+    }
+    QVERIFY(total.count() > 0);
+}
+
+void tst_elaboration::scheduleCache() {
+    const auto dir = scheduleCacheDirectory();
+    auto reference = createLeros({});
+    auto first = createLeros(dir);
+    auto second = createLeros(dir);
+    reference->verifyAndInitialize();
+    first->verifyAndInitialize();
+    second->verifyAndInitialize();
+    QVERIFY(!reference->scheduleRestored());
+    QVERIFY(!first->scheduleRestored());
+    QVERIFY(second->scheduleRestored());
+    QCOMPARE(second->propagationStackSize(), reference->propagationStackSize());
+    QCOMPARE(second->passThroughPortCount(), reference->passThroughPortCount());
+
+    std::vector<SimPort*> referencePorts, restoredPorts;
+    collectPorts(reference.get(), referencePorts);
+    collectPorts(second.get(), restoredPorts);
+    for (int cycle = 0; cycle < 200; cycle++) {
+        for (size_t i = 0; i < referencePorts.size(); i++)
+            QCOMPARE(restoredPorts[i]->uValue(), referencePorts[i]->uValue());
+        reference->clock();
+        second->clock();
+    }
+    // A restored schedule supports reversal like any other
+    for (int cycle = 0; cycle < 10; cycle++) {
+        reference->reverse();
+        second->reverse();
+    }
+    for (size_t i = 0; i < referencePorts.size(); i++)
+        QCOMPARE(restoredPorts[i]->uValue(), referencePorts[i]->uValue());
+}
+
+void tst_elaboration::scheduleCacheInvalidation() {
+    const auto dir = scheduleCacheDirectory();
+    {
+        ScalableXorNetwork<10> design;
+        design.setScheduleCacheDirectory(dir);
+        design.verifyAndInitialize();
+        QVERIFY(!design.scheduleRestored());
+    }
+    {
+        // A different structure does not match the cached schedule
+        ScalableXorNetwork<11> design;
+        design.setScheduleCacheDirectory(dir);
+        design.verifyAndInitialize();
+        QVERIFY(!design.scheduleRestored());
+    }
+    {
+        // Neither does the same structure with different options
+        ScalableXorNetwork<10> design;
+        design.setScheduleCacheDirectory(dir);
+        design.setEliminateUnobservedPorts(true);
+        design.verifyAndInitialize();
+        QVERIFY(!design.scheduleRestored());
+    }
+
+    // Corrupted cache files are ignored
+    for (const auto& entry : std::filesystem::directory_iterator(dir))
+        std::filesystem::resize_file(entry.path(), std::filesystem::file_size(entry.path()) / 2);
+    ScalableXorNetwork<10> design, reference;
+    design.setScheduleCacheDirectory(dir);
+    design.verifyAndInitialize();
+    reference.verifyAndInitialize();
+    QVERIFY(!design.scheduleRestored());
+    QCOMPARE(design.propagationStackSize(), reference.propagationStackSize());
+}
+
+void tst_elaboration::arenaAllocation() {
+    auto design = std::make_unique<ScalableXorNetwork<10>>();
+    std::vector<SimPort*> ports;
+    collectPorts(design.get(), ports);
+
+    // All components and ports of the design reside in its arena, in order of creation
+    QVERIFY(design->arena().bytesAllocated() >= ports.size() * sizeof(Port<1>));
+    QVERIFY(design->arena().bytesAllocated() >= design->xors.size() * sizeof(Or<1, 2>));
+    const auto* first = reinterpret_cast<const char*>(design->xors.front());
+    const auto* second = reinterpret_cast<const char*>(design->xors[1]);
+    QVERIFY(second > first && second - first < 4096);
+
+    design->verifyAndInitialize();
+    design->clock();
+    design.reset();
+
+    // Components outside of a design are allocated individually
+    Register<8> reg("reg", nullptr);
+    QVERIFY(reg.getPorts<SimPort::PortType::in>().size() == 1);
+}
+
+void tst_elaboration::relocatedPortData() {
+    for (auto mode : {PropagationMode::interpreted, PropagationMode::flat, PropagationMode::activity,
+                      PropagationMode::levelized}) {
+        auto reference = createLeros({});
+        auto relocated = createLeros({});
+        relocated->setRelocatePortData(true);
+        reference->verifyAndInitialize();
+        relocated->verifyAndInitialize();
+        relocated->setPropagationMode(mode);
+
+        std::vector<SimPort*> referencePorts, relocatedPorts;
+        collectPorts(reference.get(), referencePorts);
+        collectPorts(relocated.get(), relocatedPorts);
+        for (int cycle = 0; cycle < 100; cycle++) {
+            for (size_t i = 0; i < referencePorts.size(); i++)
+                QCOMPARE(relocatedPorts[i]->uValue(), referencePorts[i]->uValue());
+            reference->clock();
+            relocated->clock();
+        }
+    }
+}
+
+void tst_elaboration::wideComponents() {
+    InverterChain design;
+    Multiplexer<1024, 8> mux("mux", nullptr);
+
+    // Objects are iterated in order of their names, rather than in order of creation
+    const auto subcomponents = design.getSubComponents();
+    QCOMPARE(subcomponents.size(), size_t(InverterChain::depth + 1));
+    QVERIFY(std::is_sorted(subcomponents.begin(), subcomponents.end(),
+                           [](auto* lhs, auto* rhs) { return lhs->getName() < rhs->getName(); }));
+    QCOMPARE(subcomponents.back()->getName(), std::string("reg"));
+    const auto ins = mux.getInputPorts();
+    QCOMPARE(ins.size(), size_t(1024 + 1));
+    QCOMPARE(ins[0]->getName(), std::string("in_0"));
+    QCOMPARE(ins[1]->getName(), std::string("in_1"));
+    QCOMPARE(ins[2]->getName(), std::string("in_10"));
+
+    QCOMPARE(mux.findPort("in_517"), static_cast<SimPort*>(mux.ins[517]));
+    QCOMPARE(mux.findPort<PortBase>("out"), static_cast<PortBase*>(&mux.out));
+    QVERIFY(mux.findPort("in_1024") == nullptr);
+    QVERIFY(mux.findSignal("out") == nullptr);
+    QVERIFY_EXCEPTION_THROWN(mux.createInputPort<8>("in_3"), std::runtime_error);
+    QVERIFY_EXCEPTION_THROWN(design.create_component<Register<1>>("inverters_42"), std::runtime_error);
+
+    // Objects created after the first traversal are ordered amongst the existing objects
+    auto* reg = design.create_component<Register<1>>("a");
+    QCOMPARE(design.getSubComponents().front(), static_cast<SimComponent*>(reg));
+
+    // Sorting agrees with the order checked upon insertion, also for names outside of ASCII
+    design.create_component<Register<1>>("\xc3\xa9");
+    const auto all = design.getSubComponents();
+    QVERIFY(std::is_sorted(all.begin(), all.end(), BaseSorter<SimComponent*>()));
+}
+
+void tst_elaboration::pathLookup() {
+    NestedExponenter design;
+    QCOMPARE(design.exp->mul->out.getHierName(), design.getName() + "->exp->mul->out");
+    // Hierarchical names are cached
+    QCOMPARE(&design.exp->mul->out.getHierName(), &design.exp->mul->out.getHierName());
+
+    // Paths are resolved both prior to (by walking the hierarchy) and after initialization (through the path index)
+    for (bool initialized : {false, true}) {
+        if (initialized)
+            design.verifyAndInitialize();
+        QCOMPARE(design.lookup("exp->mul->out"), static_cast<SimBase*>(&design.exp->mul->out));
+        QCOMPARE(design.lookup(design.getName() + "->exp->mul->out"), static_cast<SimBase*>(&design.exp->mul->out));
+        QCOMPARE(design.lookup<SimComponent>("exp->expReg"), static_cast<SimComponent*>(design.exp->expReg));
+        QCOMPARE(design.lookup<SimPort>("reg->out"), static_cast<SimPort*>(&design.reg->out));
+        QVERIFY(design.lookup<SimComponent>("reg->out") == nullptr);
+        QVERIFY(design.lookup("exp->mul->nonexistent") == nullptr);
+        QVERIFY(design.lookup("nonexistent->out") == nullptr);
+        QVERIFY(design.lookup("") == nullptr);
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_elaboration)
+#include "tst_elaboration.moc"
@@ -0,0 +1,76 @@
+#include <QtTest/QTest>
+
+#include "Leros/SingleCycleLeros/SingleCycleLeros.h"
+#include "vsrtl_adder.h"
+#include "vsrtl_design.h"
+#include "vsrtl_register.h"
+
+using namespace vsrtl;
+using namespace core;
+
+namespace {
+
+// A register incrementing itself, followed by two independent loops between pairs of adders
+class LoopDesign : public Design {
+public:
+    LoopDesign() : Design("Loop design") {
+        reg->out >> inc->op1;
+        1 >> inc->op2;
+        inc->out >> reg->in;
+
+        for (auto* loop : {&loopA, &loopB}) {
+            (*loop)[0]->out >> (*loop)[1]->op1;
+            (*loop)[1]->out >> (*loop)[0]->op1;
+            reg->out >> (*loop)[0]->op2;
+            reg->out >> (*loop)[1]->op2;
+        }
+    }
+
+    SUBCOMPONENT(reg, Register<8>);
+    SUBCOMPONENT(inc, Adder<8>);
+    SUBCOMPONENTS(loopA, Adder<8>, 2);
+    SUBCOMPONENTS(loopB, Adder<8>, 2);
+};
+
+}  // namespace
+
+class tst_loopDetection : public QObject {
+    Q_OBJECT private slots : void reportsAllLoops();
+    void rejectsLoops();
+    void noLoops();
+};
+
+void tst_loopDetection::reportsAllLoops() {
+    LoopDesign design;
+    const auto loops = design.combinationalLoops();
+    QCOMPARE(loops.size(), size_t(2));
+
+    std::set<std::string> expected;
+    for (auto* loop : {&design.loopA, &design.loopB}) {
+        for (auto* adder : *loop) {
+            expected.insert(adder->op1.getHierName());
+            expected.insert(adder->out.getHierName());
+        }
+    }
+    std::set<std::string> reported;
+    for (const auto& loop : loops) {
+        QCOMPARE(loop.size(), size_t(4));
+        reported.insert(loop.begin(), loop.end());
+    }
+    QCOMPARE(reported, expected);
+}
+
+void tst_loopDetection::rejectsLoops() {
+    LoopDesign design;
+    QVERIFY_EXCEPTION_THROWN(design.verifyAndInitialize(), std::runtime_error);
+}
+
+void tst_loopDetection::noLoops() {
+    leros::SingleCycleLeros design;
+    QVERIFY(design.combinationalLoops().empty());
+    QVERIFY(!design.detectCombinationalLoop());
+    design.verifyAndInitialize();
+}
+
+QTEST_APPLESS_MAIN(tst_loopDetection)
+#include "tst_loopdetection.moc"
@@ -0,0 +1,92 @@
+#include <QtTest/QTest>
+
+#include <algorithm>
+#include <sstream>
+
+#include "tst_utils.h"
+#include "vsrtl_design.h"
+
+using namespace vsrtl;
+using namespace core;
+using namespace test;
+
+class tst_profiler : public QObject {
+    Q_OBJECT private slots : void profile();
+};
+
+#ifdef VSRTL_PROFILING
+namespace {
+
+const Profiler::Row& findRow(const std::vector<Profiler::Row>& rows, const std::string& name) {
+    auto it = std::find_if(rows.begin(), rows.end(), [&](const Profiler::Row& row) { return row.name == name; });
+    if (it == rows.end())
+        throw std::runtime_error("No profile of " + name);
+    return *it;
+}
+
+}  // namespace
+#endif
+
+void tst_profiler::profile() {
+#ifndef VSRTL_PROFILING
+    QSKIP("Profiling is not compiled in (VSRTL_PROFILING)");
+#else
+    const auto leros = createLeros();
+    auto& design = *leros;
+
+    // Elaboration is not profiled
+    for (const auto& row : design.profiler().byInstance())
+        QCOMPARE(row.ticks(), uint64_t(0));
+
+    constexpr unsigned cycles = 100;
+    for (unsigned i = 0; i < cycles; i++)
+        design.clock();
+
+    const auto instances = design.profiler().byInstance();
+    QVERIFY(std::is_sorted(instances.begin(), instances.end(), [](const Profiler::Row& lhs, const Profiler::Row& rhs) {
+        return lhs.ticks() > rhs.ticks();
+    }));
+
+    // Each port is evaluated once per cycle
+    const auto& alu = findRow(instances, design.alu_comp->getHierName());
+    QVERIFY(alu[Profiler::Event::evaluate].count > 0);
+    QCOMPARE(alu[Profiler::Event::evaluate].count % cycles, uint64_t(0));
+    QCOMPARE(alu[Profiler::Event::save].count, uint64_t(0));
+
+    // An instruction is fetched in every cycle
+    const auto& rom = findRow(instances, design.instr_mem->getHierName());
+    QVERIFY(rom[Profiler::Event::memoryRead].count >= cycles);
+
+    // Memories are saved in every cycle, and written in those cycles which store to memory
+    const auto& dataMem = findRow(instances, design.data_mem->_wr_mem->getHierName());
+    QCOMPARE(dataMem[Profiler::Event::save].count, uint64_t(cycles));
+    QVERIFY(dataMem[Profiler::Event::memoryWrite].count > 0);
+    QVERIFY(dataMem[Profiler::Event::memoryWrite].count < cycles);
+
+    // Banked registers are committed by the design
+    QCOMPARE(findRow(instances, design.getHierName())[Profiler::Event::save].count, uint64_t(cycles));
+
+    // Instances accumulate into their types
+    const auto types = design.profiler().byType();
+    QVERIFY(types.size() < instances.size());
+    uint64_t instanceEvaluations = 0, typeEvaluations = 0;
+    for (const auto& row : instances)
+        instanceEvaluations += row[Profiler::Event::evaluate].count;
+    for (const auto& row : types)
+        typeEvaluations += row[Profiler::Event::evaluate].count;
+    QCOMPARE(typeEvaluations, instanceEvaluations);
+    QVERIFY(std::any_of(types.begin(), types.end(),
+                        [](const Profiler::Row& row) { return row.name.find("ALU") != std::string::npos; }));
+
+    std::ostringstream report;
+    design.profiler().report(report);
+    QVERIFY(report.str().find(design.alu_comp->getHierName()) != std::string::npos);
+
+    design.profiler().clear();
+    for (const auto& row : design.profiler().byInstance())
+        QCOMPARE(row[Profiler::Event::evaluate].count, uint64_t(0));
+#endif
+}
+
+QTEST_APPLESS_MAIN(tst_profiler)
+#include "tst_profiler.moc"
@@ -0,0 +1,405 @@
+#include <QtTest/QTest>
+
+#include "tst_utils.h"
+#include "vsrtl_counter.h"
+#include "vsrtl_rannumgen.h"
+#include "vsrtl_registerfilecmp.h"
+#include "vsrtl_stalledpipeline.h"
+#include "vsrtl_xornetwork.h"
+
+using namespace vsrtl;
+using namespace core;
+using namespace test;
+
+class tst_propagationModes : public QObject {
+    Q_OBJECT
+
+private slots:
+    void flatCounter();
+    void flatRanNumGen();
+    void flatRegisterFile();
+    void flatXorNetwork();
+    void flatLeros();
+    void flatStalledPipeline();
+
+    void activityCounter();
+    void activityRanNumGen();
+    void activityRegisterFile();
+    void activityXorNetwork();
+    void activityLeros();
+    void activityStalledPipeline();
+
+    void levelizedCounter();
+    void levelizedRanNumGen();
+    void levelizedRegisterFile();
+    void levelizedXorNetwork();
+    void levelizedLeros();
+    void levelizedThreadCountChange();
+
+    void nativeCounter();
+    void nativeRanNumGen();
+    void nativeRegisterFile();
+    void nativeXorNetwork();
+    void nativeLeros();
+
+    void bitpackedCounter();
+    void bitpackedRanNumGen();
+    void bitpackedRegisterFile();
+    void bitpackedXorNetwork();
+    void bitpackedLeros();
+    void bitpackedGates();
+
+    void changeSets();
+    void passThroughPorts();
+    void constantFolding();
+    void unobservedPorts();
+
+public:
+    void portsChanged(const std::vector<SimPort*>& ports) { m_changeSet = ports; }
+
+private:
+    std::vector<SimPort*> m_changeSet;
+};
+
+namespace {
+
+// An accumulator of a constant-only sum, with an adder which nobody reads
+class AccumulatorDesign : public Design {
+public:
+    AccumulatorDesign() : Design("Accumulator") {
+        3 >> sum->op1;
+        4 >> sum->op2;
+        sum->out >> acc->op1;
+        reg->out >> acc->op2;
+        acc->out >> reg->in;
+        reg->out >> unused->op1;
+        reg->out >> unused->op2;
+    }
+    SUBCOMPONENT(sum, Adder<8>);
+    SUBCOMPONENT(acc, Adder<8>);
+    SUBCOMPONENT(unused, Adder<8>);
+    SUBCOMPONENT(reg, Register<8>);
+};
+
+template <typename D>
+void setupLeros(D& design) {
+    if constexpr (std::is_same<D, leros::SingleCycleLeros>::value)
+        loadLerosProgram(design);
+}
+
+/**
+ * Clocks a design propagated through @p mode in lockstep with an interpreted reference design, and verifies that all
+ * ports in the two designs hold identical values after every cycle, as well as after reversing.
+ */
+template <typename D>
+void verifyAgainstInterpreted(PropagationMode mode, unsigned cycles) {
+    D ref;
+    D dut;
+    setupLeros(ref);
+    setupLeros(dut);
+    ref.verifyAndInitialize();
+    dut.verifyAndInitialize();
+    if (mode == PropagationMode::native)
+        dut.compileNative();
+    dut.setPropagationMode(mode);
+    if (mode == PropagationMode::levelized) {
+        // Force all levels to be distributed across the worker threads
+        dut.setPropagationThreads(4);
+        dut.setParallelThreshold(1);
+    }
+    dut.setEnableSignals(false);
+
+    std::vector<SimPort*> refPorts, dutPorts;
+    collectPorts(&ref, refPorts);
+    collectPorts(&dut, dutPorts);
+    QCOMPARE(refPorts.size(), dutPorts.size());
+
+    auto compare = [&] {
+        for (unsigned i = 0; i < refPorts.size(); i++) {
+            if (refPorts[i]->uValue() != dutPorts[i]->uValue()) {
+                QFAIL(("Port value mismatch at cycle " + std::to_string(ref.getCycleCount()) + " for port " +
+                       dutPorts[i]->getHierName())
+                          .c_str());
+            }
+        }
+    };
+
+    compare();
+    for (unsigned i = 0; i < cycles; i++) {
+        ref.clock();
+        dut.clock();
+        compare();
+    }
+    for (unsigned i = 0; i < cycles / 2; i++) {
+        ref.reverse();
+        dut.reverse();
+        compare();
+    }
+    ref.reset();
+    dut.reset();
+    compare();
+}
+
+}  // namespace
+
+void tst_propagationModes::flatCounter() {
+    verifyAgainstInterpreted<Counter<8>>(PropagationMode::flat, 300);
+}
+
+void tst_propagationModes::flatRanNumGen() {
+    verifyAgainstInterpreted<RanNumGen>(PropagationMode::flat, 100);
+}
+
+void tst_propagationModes::flatRegisterFile() {
+    verifyAgainstInterpreted<RegisterFileTester>(PropagationMode::flat, 100);
+}
+
+void tst_propagationModes::flatXorNetwork() {
+    verifyAgainstInterpreted<XorNetwork>(PropagationMode::flat, 20);
+}
+
+void tst_propagationModes::flatLeros() {
+    verifyAgainstInterpreted<leros::SingleCycleLeros>(PropagationMode::flat, 200);
+}
+
+void tst_propagationModes::flatStalledPipeline() {
+    verifyAgainstInterpreted<StalledPipeline>(PropagationMode::flat, 100);
+}
+
+void tst_propagationModes::activityCounter() {
+    verifyAgainstInterpreted<Counter<8>>(PropagationMode::activity, 300);
+}
+
+void tst_propagationModes::activityRanNumGen() {
+    verifyAgainstInterpreted<RanNumGen>(PropagationMode::activity, 100);
+}
+
+void tst_propagationModes::activityRegisterFile() {
+    verifyAgainstInterpreted<RegisterFileTester>(PropagationMode::activity, 100);
+}
+
+void tst_propagationModes::activityXorNetwork() {
+    verifyAgainstInterpreted<XorNetwork>(PropagationMode::activity, 20);
+}
+
+void tst_propagationModes::activityLeros() {
+    verifyAgainstInterpreted<leros::SingleCycleLeros>(PropagationMode::activity, 200);
+}
+
+void tst_propagationModes::activityStalledPipeline() {
+    verifyAgainstInterpreted<StalledPipeline>(PropagationMode::activity, 100);
+}
+
+void tst_propagationModes::levelizedCounter() {
+    verifyAgainstInterpreted<Counter<8>>(PropagationMode::levelized, 300);
+}
+
+void tst_propagationModes::levelizedRanNumGen() {
+    verifyAgainstInterpreted<RanNumGen>(PropagationMode::levelized, 100);
+}
+
+void tst_propagationModes::levelizedRegisterFile() {
+    verifyAgainstInterpreted<RegisterFileTester>(PropagationMode::levelized, 100);
+}
+
+void tst_propagationModes::levelizedXorNetwork() {
+    verifyAgainstInterpreted<XorNetwork>(PropagationMode::levelized, 20);
+}
+
+void tst_propagationModes::levelizedLeros() {
+    verifyAgainstInterpreted<leros::SingleCycleLeros>(PropagationMode::levelized, 200);
+}
+
+void tst_propagationModes::levelizedThreadCountChange() {
+    // Worker threads are restarted when the thread count changes, and must resume in step with the calling thread
+    XorNetwork ref;
+    XorNetwork dut;
+    ref.verifyAndInitialize();
+    dut.verifyAndInitialize();
+    dut.setPropagationMode(PropagationMode::levelized);
+    dut.setParallelThreshold(1);
+    dut.setEnableSignals(false);
+
+    std::vector<SimPort*> refPorts, dutPorts;
+    collectPorts(&ref, refPorts);
+    collectPorts(&dut, dutPorts);
+    for (unsigned threads : {4, 2, 3, 4, 1, 4}) {
+        dut.setPropagationThreads(threads);
+        for (unsigned i = 0; i < 10; i++) {
+            ref.clock();
+            dut.clock();
+            for (unsigned j = 0; j < refPorts.size(); j++)
+                QCOMPARE(dutPorts[j]->uValue(), refPorts[j]->uValue());
+        }
+    }
+}
+
+void tst_propagationModes::nativeCounter() {
+    verifyAgainstInterpreted<Counter<8>>(PropagationMode::native, 300);
+}
+
+void tst_propagationModes::nativeRanNumGen() {
+    verifyAgainstInterpreted<RanNumGen>(PropagationMode::native, 100);
+}
+
+void tst_propagationModes::nativeRegisterFile() {
+    verifyAgainstInterpreted<RegisterFileTester>(PropagationMode::native, 100);
+}
+
+void tst_propagationModes::nativeXorNetwork() {
+    verifyAgainstInterpreted<XorNetwork>(PropagationMode::native, 20);
+}
+
+void tst_propagationModes::nativeLeros() {
+    verifyAgainstInterpreted<leros::SingleCycleLeros>(PropagationMode::native, 200);
+}
+
+void tst_propagationModes::bitpackedCounter() {
+    verifyAgainstInterpreted<Counter<8>>(PropagationMode::bitpacked, 300);
+}
+
+void tst_propagationModes::bitpackedRanNumGen() {
+    verifyAgainstInterpreted<RanNumGen>(PropagationMode::bitpacked, 100);
+}
+
+void tst_propagationModes::bitpackedRegisterFile() {
+    verifyAgainstInterpreted<RegisterFileTester>(PropagationMode::bitpacked, 100);
+}
+
+void tst_propagationModes::bitpackedXorNetwork() {
+    verifyAgainstInterpreted<XorNetwork>(PropagationMode::bitpacked, 20);
+}
+
+void tst_propagationModes::bitpackedLeros() {
+    verifyAgainstInterpreted<leros::SingleCycleLeros>(PropagationMode::bitpacked, 200);
+}
+
+void tst_propagationModes::bitpackedGates() {
+    // All gates of the network are packed, and each column of gates is evaluated by a few word operations
+    XorNetwork design;
+    design.verifyAndInitialize();
+    const auto& netlist = design.bitNetlist();
+    QCOMPARE(netlist.gateCount(), size_t(XorNetwork::rows * XorNetwork::cols));
+    QVERIFY(netlist.opCount() < netlist.gateCount());
+}
+
+void tst_propagationModes::changeSets() {
+    // The change set of each cycle must contain exactly the ports which changed value, regardless of propagation mode
+    for (auto mode : {PropagationMode::interpreted, PropagationMode::flat, PropagationMode::activity,
+                      PropagationMode::levelized, PropagationMode::bitpacked}) {
+        leros::SingleCycleLeros design;
+        setupLeros(design);
+        design.verifyAndInitialize();
+        design.setPropagationMode(mode);
+        design.setEnableSignals(false);
+        design.setEnableChangeSets(true);
+        design.portsChanged.Connect(this, &tst_propagationModes::portsChanged);
+
+        std::vector<SimPort*> ports;
+        collectPorts(&design, ports);
+        for (unsigned i = 0; i < 50; i++) {
+            std::map<SimPort*, VSRTL_VT_U> preValues;
+            for (auto* p : ports)
+                preValues[p] = p->uValue();
+            m_changeSet.clear();
+            if (i % 10 == 9)
+                design.reverse();
+            else
+                design.clock();
+
+            std::set<SimPort*> expected;
+            for (auto* p : ports) {
+                if (p->uValue() != preValues[p])
+                    expected.insert(p);
+            }
+            QCOMPARE(std::set<SimPort*>(m_changeSet.begin(), m_changeSet.end()), expected);
+            QCOMPARE(m_changeSet.size(), expected.size());
+        }
+    }
+}
+
+void tst_propagationModes::passThroughPorts() {
+    // Ports which forward their input port are not propagated, yet always hold the value of the port which they forward
+    leros::SingleCycleLeros design;
+    setupLeros(design);
+    design.verifyAndInitialize();
+    QVERIFY(design.passThroughPortCount() > 0);
+
+    std::vector<SimPort*> ports;
+    collectPorts(&design, ports);
+    std::vector<PortBase*> forwarding;
+    for (auto* p : ports) {
+        auto* port = dynamic_cast<PortBase*>(p);
+        if (!port->hasPropagationFunction() && port->getInputPort() != nullptr)
+            forwarding.push_back(port);
+    }
+    QVERIFY(forwarding.size() >= design.passThroughPortCount());
+
+    design.setPropagationMode(PropagationMode::flat);
+    design.setEnableSignals(false);
+    for (unsigned i = 0; i < 50; i++) {
+        if (i % 10 == 9)
+            design.reverse();
+        else
+            design.clock();
+        for (auto* port : forwarding)
+            QCOMPARE(port->uValue(), port->getInputPort()->uValue());
+    }
+}
+
+void tst_propagationModes::constantFolding() {
+    // The constant-only sum is evaluated once during elaboration
+    AccumulatorDesign design;
+    design.verifyAndInitialize();
+    QCOMPARE(design.foldedComponentCount(), size_t(1));
+    QVERIFY(design.sum->out.isConstant());
+    QVERIFY(design.acc->op1.isConstant());
+    QCOMPARE(design.sum->out.uValue(), VSRTL_VT_U(7));
+
+    design.setEnableSignals(false);
+    design.setPropagationMode(PropagationMode::flat);
+    for (unsigned i = 0; i < 5; i++)
+        design.clock();
+    QCOMPARE(design.reg->out.uValue(), VSRTL_VT_U(35));
+    design.reverse();
+    QCOMPARE(design.acc->out.uValue(), VSRTL_VT_U(35));
+    design.reset();
+    QCOMPARE(design.sum->out.uValue(), VSRTL_VT_U(7));
+    QCOMPARE(design.acc->out.uValue(), VSRTL_VT_U(7));
+}
+
+void tst_propagationModes::unobservedPorts() {
+    {
+        AccumulatorDesign design;
+        design.setEliminateUnobservedPorts(true);
+        design.verifyAndInitialize();
+        QCOMPARE(design.unobservedPortCount(), size_t(1));
+
+        // Unobserved ports are left stale while running headless...
+        design.setEnableSignals(false);
+        design.setPropagationMode(PropagationMode::flat);
+        for (unsigned i = 0; i < 5; i++)
+            design.clock();
+        QCOMPARE(design.reg->out.uValue(), VSRTL_VT_U(35));
+        QVERIFY(design.unused->out.uValue() != VSRTL_VT_U(70));
+
+        // ... and propagated once they may be observed
+        design.setEnableChangeSets(true);
+        design.clock();
+        QCOMPARE(design.unused->out.uValue(), VSRTL_VT_U(84));
+        design.setEnableChangeSets(false);
+        design.setEnableSignals(true);
+        design.clock();
+        QCOMPARE(design.unused->out.uValue(), VSRTL_VT_U(98));
+    }
+    {
+        AccumulatorDesign design;
+        design.setEliminateUnobservedPorts(true);
+        design.addProbe(&design.unused->out);
+        design.verifyAndInitialize();
+        QCOMPARE(design.unobservedPortCount(), size_t(0));
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_propagationModes)
+#include "tst_propagationmodes.moc"
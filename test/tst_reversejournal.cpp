@@ -0,0 +1,189 @@
+#include <QtTest/QTest>
+
+#include "vsrtl_adder.h"
+#include "vsrtl_constant.h"
+#include "vsrtl_decollator.h"
+#include "vsrtl_design.h"
+#include "vsrtl_memory.h"
+#include "vsrtl_register.h"
+
+using namespace vsrtl;
+using namespace core;
+
+namespace {
+
+// A counter, a shift register and an enabled register following the counter, and a bank of registers which hold their
+// value
+class JournalDesign : public Design {
+public:
+    static constexpr unsigned int idleRegisters = 100;
+
+    JournalDesign() : Design("Journal design") {
+        counter->out >> inc->op1;
+        1 >> inc->op2;
+        inc->out >> counter->in;
+
+        counter->out >> shift->in;
+        counter->out >> enabled->in;
+        counter->out >> enableBit->in;
+        0 >> enabled->clear;
+        *enableBit->out[0] >> enabled->enable;
+
+        for (auto* reg : idle)
+            reg->out >> reg->in;
+    }
+
+    SUBCOMPONENT(counter, Register<8>);
+    SUBCOMPONENT(inc, Adder<8>);
+    SUBCOMPONENT(shift, ShiftRegister<8>);
+    SUBCOMPONENT(enabled, RegisterClEn<8>);
+    SUBCOMPONENT(enableBit, Decollator<8>);
+    SUBCOMPONENTS(idle, Register<8>, idleRegisters);
+};
+
+// A counter, and a memory which is written the same value at the same address in every cycle
+class MemoryDesign : public Design {
+public:
+    MemoryDesign() : Design("Memory design") {
+        counter->out >> inc->op1;
+        1 >> inc->op2;
+        inc->out >> counter->in;
+
+        mem->setMemory(m_memory);
+        0x10 >> mem->addr;
+        0xAB >> mem->data_in;
+        1 >> mem->wr_width;
+        1 >> mem->wr_en;
+    }
+
+    SUBCOMPONENT(counter, Register<8>);
+    SUBCOMPONENT(inc, Adder<8>);
+    SUBCOMPONENT(mem, TYPE(WrMemory<8, 8>));
+    ADDRESSSPACE(m_memory);
+};
+
+std::vector<VSRTL_VT_U> state(JournalDesign& design) {
+    return {design.counter->out.uValue(), design.shift->out.uValue(), design.enabled->out.uValue()};
+}
+
+}  // namespace
+
+class tst_reverseJournal : public QObject {
+    Q_OBJECT private slots : void reversesToPriorStates();
+    void journalsOnlyChanges();
+    void boundedDepth();
+    void reversesForcedValues();
+    void bankedRegisters();
+    void unchangedMemoryWrites();
+};
+
+void tst_reverseJournal::reversesToPriorStates() {
+    JournalDesign design;
+    design.verifyAndInitialize();
+
+    std::vector<std::vector<VSRTL_VT_U>> states;
+    for (int i = 0; i < 50; i++) {
+        states.push_back(state(design));
+        design.clock();
+    }
+    for (int i = 49; i >= 0; i--) {
+        design.reverse();
+        QCOMPARE(state(design), states[i]);
+    }
+    QVERIFY(!design.canReverse());
+}
+
+void tst_reverseJournal::journalsOnlyChanges() {
+    JournalDesign design;
+    design.verifyAndInitialize();
+
+    // Registers holding their value are never journaled, regardless of their number
+    for (int i = 0; i < 40; i++)
+        design.clock();
+    QCOMPARE(design.reverseJournal().cycleCount(), size_t(40));
+    // Per cycle, the counter changes, the shift register shifts in a new value, and the enabled register is updated
+    // in every other cycle, with the exception of the first cycle (enable = 0, and the shift register holds 0 in all
+    // stages while shifting in 0)
+    QCOMPARE(design.reverseJournal().entryCount(), size_t(40 + 39 + 20));
+}
+
+void tst_reverseJournal::boundedDepth() {
+    JournalDesign design;
+    design.verifyAndInitialize();
+    design.setReverseStackSize(10);
+
+    for (int i = 0; i < 30; i++)
+        design.clock();
+    QCOMPARE(design.reverseJournal().cycleCount(), size_t(10));
+    QCOMPARE(design.counter->out.uValue(), VSRTL_VT_U(30));
+    for (int i = 0; i < 10; i++)
+        design.reverse();
+    QCOMPARE(design.counter->out.uValue(), VSRTL_VT_U(20));
+    QVERIFY(!design.canReverse());
+    QCOMPARE(design.reverseJournal().entryCount(), size_t(0));
+
+    design.setReverseStackSize(100);
+}
+
+void tst_reverseJournal::reversesForcedValues() {
+    JournalDesign design;
+    design.verifyAndInitialize();
+
+    design.clock();
+    design.clock();
+    design.setSynchronousValue(design.counter, 0, 42);
+    QCOMPARE(design.counter->out.uValue(), VSRTL_VT_U(42));
+    design.clock();
+    QCOMPARE(design.counter->out.uValue(), VSRTL_VT_U(43));
+
+    // A forced value is a modification of the cycle in which it was forced
+    design.reverse();
+    QCOMPARE(design.counter->out.uValue(), VSRTL_VT_U(42));
+    design.reverse();
+    QCOMPARE(design.counter->out.uValue(), VSRTL_VT_U(1));
+}
+
+void tst_reverseJournal::bankedRegisters() {
+    JournalDesign design;
+    design.verifyAndInitialize();
+
+    // Plain and enabled registers are committed through the register bank; shift registers are saved individually
+    QCOMPARE(design.bankedRegisterCount(), size_t(2 + JournalDesign::idleRegisters));
+    for (int i = 0; i < 5; i++)
+        design.clock();
+    QCOMPARE(design.counter->out.uValue(), VSRTL_VT_U(5));
+    QCOMPARE(design.idle[0]->out.uValue(), VSRTL_VT_U(0));
+
+    // Banked state is part of snapshots, and may be forced and reversed like any other
+    const auto snapshot = design.snapshot();
+    design.setSynchronousValue(design.idle[0], 0, 7);
+    design.clock();
+    QCOMPARE(design.idle[0]->out.uValue(), VSRTL_VT_U(7));
+    design.reverse();
+    QCOMPARE(design.idle[0]->out.uValue(), VSRTL_VT_U(7));
+    design.reverse();
+    QCOMPARE(design.idle[0]->out.uValue(), VSRTL_VT_U(0));
+    design.clock();
+    design.restore(snapshot);
+    QCOMPARE(design.counter->out.uValue(), VSRTL_VT_U(5));
+}
+
+void tst_reverseJournal::unchangedMemoryWrites() {
+    MemoryDesign design;
+    design.verifyAndInitialize();
+
+    // Only the first write changes the memory, and as such is the only write which is journaled
+    for (int i = 0; i < 10; i++)
+        design.clock();
+    QCOMPARE(design.m_memory->readMemConst(0x10, 1), VSRTL_VT_U(0xAB));
+    QCOMPARE(design.reverseJournal().entryCount(), size_t(10 + 1));
+
+    for (int i = 0; i < 9; i++)
+        design.reverse();
+    QCOMPARE(design.m_memory->readMemConst(0x10, 1), VSRTL_VT_U(0xAB));
+    design.reverse();
+    QCOMPARE(design.m_memory->readMemConst(0x10, 1), VSRTL_VT_U(0));
+}
+
+QTEST_APPLESS_MAIN(tst_reverseJournal)
+#include "tst_reversejournal.moc"
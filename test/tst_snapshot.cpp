@@ -0,0 +1,239 @@
+#include <QtTest/QTest>
+
+#include "tst_utils.h"
+#include "vsrtl_adder.h"
+#include "vsrtl_constant.h"
+#include "vsrtl_design.h"
+#include "vsrtl_register.h"
+
+using namespace vsrtl;
+using namespace core;
+using namespace test;
+
+namespace {
+
+std::vector<VSRTL_VT_U> portValues(SimComponent* design) {
+    std::vector<SimPort*> ports;
+    collectPorts(design, ports);
+    std::vector<VSRTL_VT_U> values;
+    for (auto* p : ports)
+        values.push_back(p->uValue());
+    return values;
+}
+
+class ShiftDesign : public Design {
+public:
+    ShiftDesign() : Design("Shift design") {
+        counter->out >> inc->op1;
+        1 >> inc->op2;
+        inc->out >> counter->in;
+        counter->out >> shift->in;
+        shift->stages.setValue(4);
+    }
+
+    SUBCOMPONENT(counter, Register<8>);
+    SUBCOMPONENT(inc, Adder<8>);
+    SUBCOMPONENT(shift, ShiftRegister<8>);
+    ADDRESSSPACE(memory);
+};
+
+}  // namespace
+
+class tst_snapshot : public QObject {
+    Q_OBJECT private slots : void restoresState();
+    void restoresIntoOtherInstance();
+    void sparseMemories();
+    void rejectsMismatchedSnapshots();
+    void seeksToPastCycles();
+    void seekReplaysForcedValues();
+    void seekBeyondHistory();
+};
+
+void tst_snapshot::restoresState() {
+    auto design = createLeros();
+    for (int i = 0; i < 100; i++)
+        design->clock();
+    const auto snapshot = design->snapshot();
+    const auto values = portValues(design.get());
+    const auto memory = design->m_memory->contents();
+
+    for (int i = 0; i < 100; i++)
+        design->clock();
+    QVERIFY(portValues(design.get()) != values);
+
+    design->restore(snapshot);
+    QCOMPARE(design->getCycleCount(), 100LL);
+    QCOMPARE(portValues(design.get()), values);
+    QVERIFY(design->m_memory->contents() == memory);
+    // Cycles prior to the restored state are not reversible
+    QVERIFY(!design->canReverse());
+}
+
+void tst_snapshot::restoresIntoOtherInstance() {
+    auto reference = createLeros();
+    for (int i = 0; i < 57; i++)
+        reference->clock();
+
+    auto design = createLeros();
+    design->restore(reference->snapshot());
+    // Both designs continue identically from the restored state
+    for (int i = 0; i < 100; i++) {
+        QCOMPARE(portValues(design.get()), portValues(reference.get()));
+        reference->clock();
+        design->clock();
+    }
+    QVERIFY(design->m_memory->contents() == reference->m_memory->contents());
+    QCOMPARE(design->getCycleCount(), reference->getCycleCount());
+
+    // And remain reversible after being restored
+    for (int i = 0; i < 10; i++) {
+        reference->reverse();
+        design->reverse();
+    }
+    QCOMPARE(portValues(design.get()), portValues(reference.get()));
+}
+
+void tst_snapshot::sparseMemories() {
+    ShiftDesign design;
+    design.verifyAndInitialize();
+    for (int i = 0; i < 3; i++)
+        design.clock();
+    const auto empty = design.snapshot();
+
+    // Distant bytes cost little more than their values; the gap between them is not encoded
+    design.memory->writeMem(0x10, 0x11223344, 4);
+    design.memory->writeMem(0x7FFFFFF0, 0xAB, 1);
+    const auto snapshot = design.snapshot();
+    QVERIFY(snapshot.size() < empty.size() + 24);
+
+    ShiftDesign restored;
+    restored.verifyAndInitialize();
+    restored.restore(snapshot);
+    QVERIFY(restored.memory->contents() == design.memory->contents());
+    QCOMPARE(restored.memory->readMem(0x10, 4), VSRTL_VT_U(0x11223344));
+    QCOMPARE(restored.memory->readMem(0x7FFFFFF0, 1), VSRTL_VT_U(0xAB));
+    QCOMPARE(restored.counter->out.uValue(), VSRTL_VT_U(3));
+    QCOMPARE(restored.shift->out.uValue(), design.shift->out.uValue());
+    for (int i = 0; i < 4; i++) {
+        design.clock();
+        restored.clock();
+        QCOMPARE(restored.shift->out.uValue(), design.shift->out.uValue());
+    }
+}
+
+void tst_snapshot::rejectsMismatchedSnapshots() {
+    ShiftDesign design;
+    design.verifyAndInitialize();
+    for (int i = 0; i < 5; i++)
+        design.clock();
+    const auto values = portValues(&design);
+
+    auto leros = createLeros();
+    QVERIFY_EXCEPTION_THROWN(design.restore(leros->snapshot()), std::runtime_error);
+
+    auto truncated = design.snapshot();
+    truncated.pop_back();
+    QVERIFY_EXCEPTION_THROWN(design.restore(truncated), std::runtime_error);
+    QVERIFY_EXCEPTION_THROWN(design.restore({}), std::runtime_error);
+
+    // Rejected snapshots leave the design unmodified
+    QCOMPARE(portValues(&design), values);
+    QCOMPARE(design.getCycleCount(), 5LL);
+    QCOMPARE(design.reverseJournal().cycleCount(), size_t(5));
+}
+
+void tst_snapshot::seeksToPastCycles() {
+    auto reference = createLeros();
+    auto design = createLeros();
+    design->setCheckpointInterval(64);
+    design->setReverseStackSize(10);
+
+    std::vector<std::vector<VSRTL_VT_U>> values;
+    std::vector<std::vector<std::pair<VSRTL_VT_U, uint8_t>>> memory;
+    for (int i = 0; i <= 1000; i++) {
+        values.push_back(portValues(reference.get()));
+        memory.push_back(reference->m_memory->contents());
+        reference->clock();
+        design->clock();
+    }
+    QCOMPARE(design->checkpointCount(), size_t(1000 / 64 + 1));
+
+    // Both far (replayed from a checkpoint) and near (reversed) cycles, in either direction
+    for (long long cycle : {3LL, 500LL, 495LL, 64LL, 999LL, 1000LL, 0LL, 700LL}) {
+        design->seek(cycle);
+        QCOMPARE(design->getCycleCount(), cycle);
+        QCOMPARE(portValues(design.get()), values[cycle]);
+        QVERIFY(design->m_memory->contents() == memory[cycle]);
+    }
+
+    // Cycles following the seeked cycle are reversible
+    design->reverse();
+    QCOMPARE(portValues(design.get()), values[699]);
+
+    // Seeking beyond the simulated history clocks the design
+    design->seek(1200);
+    for (long long i = reference->getCycleCount(); i < 1200; i++)
+        reference->clock();
+    QCOMPARE(portValues(design.get()), portValues(reference.get()));
+
+    design->setReverseStackSize(100);
+}
+
+void tst_snapshot::seekReplaysForcedValues() {
+    ShiftDesign design;
+    design.setCheckpointInterval(8);
+    design.setReverseStackSize(2);
+    design.verifyAndInitialize();
+
+    for (int i = 0; i < 10; i++)
+        design.clock();
+    design.setSynchronousValue(design.counter, 0, 100);
+    for (int i = 0; i < 20; i++)
+        design.clock();
+    QCOMPARE(design.counter->out.uValue(), VSRTL_VT_U(120));
+
+    design.seek(12);
+    QCOMPARE(design.counter->out.uValue(), VSRTL_VT_U(102));
+    design.seek(10);
+    QCOMPARE(design.counter->out.uValue(), VSRTL_VT_U(100));
+    design.seek(30);
+    QCOMPARE(design.counter->out.uValue(), VSRTL_VT_U(120));
+
+    // Clocking past a forced value without reapplying it discards the history which followed it
+    design.seek(5);
+    for (int i = 0; i < 25; i++)
+        design.clock();
+    QCOMPARE(design.counter->out.uValue(), VSRTL_VT_U(30));
+    design.seek(12);
+    QCOMPARE(design.counter->out.uValue(), VSRTL_VT_U(12));
+
+    design.setReverseStackSize(100);
+}
+
+void tst_snapshot::seekBeyondHistory() {
+    ShiftDesign design;
+    design.verifyAndInitialize();
+    design.setReverseStackSize(5);
+    for (int i = 0; i < 20; i++)
+        design.clock();
+
+    // Without checkpoints, only the reversible cycles may be reached
+    QVERIFY_EXCEPTION_THROWN(design.seek(10), std::runtime_error);
+    QVERIFY_EXCEPTION_THROWN(design.seek(-1), std::runtime_error);
+    QCOMPARE(design.getCycleCount(), 20LL);
+    design.seek(15);
+    QCOMPARE(design.counter->out.uValue(), VSRTL_VT_U(15));
+
+    // Checkpointing starts from the current cycle
+    design.setCheckpointInterval(4);
+    for (int i = 0; i < 20; i++)
+        design.clock();
+    design.seek(16);
+    QCOMPARE(design.counter->out.uValue(), VSRTL_VT_U(16));
+    QVERIFY_EXCEPTION_THROWN(design.seek(14), std::runtime_error);
+
+    design.setReverseStackSize(100);
+}
+
+QTEST_APPLESS_MAIN(tst_snapshot)
+#include "tst_snapshot.moc"
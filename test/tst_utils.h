@@ -0,0 +1,42 @@
+#ifndef TST_UTILS_H
+#define TST_UTILS_H
+
+#include "Leros/SingleCycleLeros/SingleCycleLeros.h"
+
+#include <memory>
+#include <vector>
+
+namespace vsrtl {
+namespace test {
+
+/**
+ * Collects all ports of a design in a deterministic (name-sorted) order, such that ports of two instances of the same
+ * design may be compared pairwise.
+ */
+template <typename T = SimPort>
+void collectPorts(SimComponent* c, std::vector<T*>& ports) {
+    for (auto* p : c->getAllPorts<T>())
+        ports.push_back(p);
+    for (auto* sc : c->getSubComponents())
+        collectPorts(sc, ports);
+}
+
+/// Loads a program into @p design which increments a value in memory at 0x100 (see tst_leros::incInMemory).
+inline void loadLerosProgram(leros::SingleCycleLeros& design) {
+    static const std::vector<unsigned short> program = {0x2901, 0x3000, 0x5000, 0x2100, 0x7000,
+                                                        0x6000, 0x0901, 0x7000, 0x2100, 0x8FFC};
+    design.m_memory->addInitializationMemory(0x0, program.data(), program.size());
+}
+
+/// Creates an initialized SingleCycleLeros running the program of loadLerosProgram().
+inline std::unique_ptr<leros::SingleCycleLeros> createLeros() {
+    auto design = std::make_unique<leros::SingleCycleLeros>();
+    loadLerosProgram(*design);
+    design->verifyAndInitialize();
+    return design;
+}
+
+}  // namespace test
+}  // namespace vsrtl
+
+#endif  // TST_UTILS_H